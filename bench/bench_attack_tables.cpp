@@ -0,0 +1,68 @@
+#include "bench_util.h"
+#include "../core/attack_tables.h"
+#include <cstdlib>
+
+namespace {
+
+bool knightByDelta(Position from, Position to) {
+    int row_diff = std::abs(to.row - from.row);
+    int col_diff = std::abs(to.col - from.col);
+    return (row_diff == 2 && col_diff == 1) || (row_diff == 1 && col_diff == 2);
+}
+
+bool kingByDelta(Position from, Position to) {
+    int row_diff = std::abs(to.row - from.row);
+    int col_diff = std::abs(to.col - from.col);
+    return row_diff <= 1 && col_diff <= 1 && (row_diff | col_diff) != 0;
+}
+
+bool whitePawnCaptureByDelta(Position from, Position to) {
+    return to.row == from.row + 1 && (to.col == from.col - 1 || to.col == from.col + 1);
+}
+
+// Every (from, target) pair, the way the validator used to answer it.
+template <typename Check>
+int sweepByDelta(Check check) {
+    int hits = 0;
+    for (int from = 0; from < kSquareCount; from++) {
+        for (int to = 0; to < kSquareCount; to++) {
+            hits += check(squarePosition(from), squarePosition(to));
+        }
+    }
+    return hits;
+}
+
+int sweepByTable(const attacks::SquareTable& table) {
+    int hits = 0;
+    for (int from = 0; from < kSquareCount; from++) {
+        for (int to = 0; to < kSquareCount; to++) {
+            hits += (table[from] & squareBit(to)) != 0;
+        }
+    }
+    return hits;
+}
+
+}
+
+BENCHMARK(AttackTablesVsDeltaChecks) {
+    const int64_t iterations = 20000;
+
+    struct Case {
+        const char* name;
+        bool (*delta)(Position, Position);
+        const attacks::SquareTable& table;
+    };
+    const Case cases[] = {
+            {"knight", knightByDelta, attacks::kKnightAttacks},
+            {"king", kingByDelta, attacks::kKingAttacks},
+            {"white pawn capture", whitePawnCaptureByDelta, attacks::kPawnAttacks[0]},
+    };
+
+    for (const auto& c : cases) {
+        double delta_ns = measureNs(iterations, [&] { keepResult(sweepByDelta(c.delta)); }) / 4096.0;
+        double table_ns = measureNs(iterations, [&] { keepResult(sweepByTable(c.table)); }) / 4096.0;
+        reportResult(std::string(c.name) + " delta check", delta_ns);
+        reportResult(std::string(c.name) + " table lookup", table_ns);
+        reportRatio(std::string(c.name) + " speedup", delta_ns, table_ns);
+    }
+}
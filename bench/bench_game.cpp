@@ -0,0 +1,103 @@
+#include "bench_util.h"
+#include "../core/game.h"
+#include "../utility/clock_source.h"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+std::unique_ptr<Game> startedGame(ManualClock** clock = nullptr) {
+    auto manual = std::make_unique<ManualClock>();
+    if (clock) {
+        *clock = manual.get();
+    }
+    auto game = std::make_unique<Game>(nullptr, std::move(manual));
+    GameSettings settings{};
+    settings.white_cooldown_ticks = 1;
+    settings.black_cooldown_ticks = 1;
+    settings.tick_rate_ms = 100;
+    settings.fen_string = "standard";
+    game->applySettings(settings);
+    game->start();
+    return game;
+}
+
+// What the renderer does each frame: every piece and its cooldown.
+int drawFrame(const Game& game) {
+    int drawn = 0;
+    Game::SnapshotRef snapshot = game.snapshot();
+    snapshot->forEachPiece([&](const Piece& piece) {
+        drawn += piece.position.row + (snapshot->cooldownRemaining(piece.id, ClockSource::Time::zero()).count() > 0);
+    });
+    return drawn;
+}
+
+int drawFrameFromBoard(const Game& game) {
+    int drawn = 0;
+    for (const Piece& piece : game.getBoard().getAllPieces(false)) {
+        drawn += piece.position.row + (piece.cooldown_ticks_remaining > 0);
+    }
+    return drawn;
+}
+
+}
+
+BENCHMARK(GameSnapshotReads) {
+    const int64_t iterations = 200000;
+    auto game = startedGame();
+
+    double snapshot_ns = measureNs(iterations, [&]() { keepResult(game->snapshot()->hash()); });
+    double board_ns = measureNs(iterations / 10, [&]() { keepResult(game->getBoard().hash()); });
+    reportResult("snapshot() hash", snapshot_ns);
+    reportResult("getBoard() hash", board_ns);
+    reportRatio("snapshot vs full board", board_ns, snapshot_ns);
+
+    uint32_t knight = game->snapshot()->pieceAt({0, 6})->id;
+    double moves_ns = measureNs(iterations / 10, [&]() { keepResult(game->getValidMoves(knight).size()); });
+    reportResult("getValidMoves()", moves_ns);
+
+    double frame_ns = measureNs(iterations / 10, [&]() { keepResult(drawFrame(*game)); });
+    double frame_board_ns = measureNs(iterations / 10, [&]() { keepResult(drawFrameFromBoard(*game)); });
+    reportResult("frame from snapshot", frame_ns);
+    reportResult("frame from getBoard()", frame_board_ns);
+    reportRatio("frame", frame_board_ns, frame_ns);
+}
+
+// Renderer-like readers while one thread keeps moving a knight and stepping
+// the clock past its cooldown: the writer's cost per move with and without
+// readers, and how many frames the readers drew meanwhile.
+BENCHMARK(GameSnapshotsUnderMoves) {
+    const int64_t moves = 20000;
+    for (int readers : {0, 2}) {
+        ManualClock* clock = nullptr;
+        auto game = startedGame(&clock);
+        uint32_t knight = game->snapshot()->pieceAt({0, 6})->id;
+        Position squares[2] = {{2, 5}, {0, 6}};
+
+        std::atomic<bool> done{false};
+        std::atomic<int64_t> reads{0};
+        std::vector<std::thread> threads;
+        for (int i = 0; i < readers; i++) {
+            threads.emplace_back([&]() {
+                int64_t local = 0;
+                while (!done.load(std::memory_order_relaxed)) {
+                    keepResult(drawFrame(*game));
+                    local++;
+                }
+                reads += local;
+            });
+        }
+
+        int64_t hop = 0;
+        double move_ns = measureNs(moves, [&]() {
+            game->makeMove(knight, squares[hop++ % 2]);
+            clock->advance();
+        });
+        done = true;
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        reportResult("move and tick, " + std::to_string(readers) + " readers", move_ns);
+        reportValue("frames read, " + std::to_string(readers) + " readers", static_cast<double>(reads.load()), "");
+    }
+}
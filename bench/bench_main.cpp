@@ -0,0 +1,37 @@
+#include "bench_util.h"
+#include <iomanip>
+#include <iostream>
+
+std::vector<Benchmark>& benchmarkRegistry() {
+    static std::vector<Benchmark> registry;
+    return registry;
+}
+
+void reportResult(const std::string& label, double ns_per_op) {
+    std::cout << "  " << std::left << std::setw(44) << label
+              << std::right << std::fixed << std::setprecision(1) << std::setw(12) << ns_per_op << " ns/op" << std::endl;
+}
+
+void reportRatio(const std::string& label, double baseline_ns, double optimized_ns) {
+    std::cout << "  " << std::left << std::setw(44) << label
+              << std::right << std::fixed << std::setprecision(2) << std::setw(12) << baseline_ns / optimized_ns << " x" << std::endl;
+}
+
+void reportValue(const std::string& label, double value, const std::string& unit) {
+    std::cout << "  " << std::left << std::setw(44) << label
+              << std::right << std::fixed << std::setprecision(1) << std::setw(12) << value << " " << unit << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::string filter = argc > 1 ? argv[1] : "";
+
+    for (const auto& benchmark : benchmarkRegistry()) {
+        if (!filter.empty() && benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+        std::cout << benchmark.name << std::endl;
+        benchmark.run();
+    }
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include "bench_util.h"
+#include "../utility/scheduler.h"
+#include "../utility/timer.h"
+#include <algorithm>
+#include <atomic>
+#include <ctime>
+#include <random>
+#include <thread>
+
+namespace {
+
+using Clock = Scheduler::Clock;
+
+// Lateness histogram in 10 us buckets; the last one collects the rest.
+constexpr int kBuckets = 100000;
+constexpr std::chrono::microseconds kBucketWidth(10);
+
+struct Histogram {
+    std::vector<std::atomic<uint64_t>> buckets;
+    std::atomic<uint64_t> count{0};
+    std::atomic<int64_t> max_us{0};
+
+    Histogram() : buckets(kBuckets) {}
+
+    void add(std::chrono::microseconds lateness) {
+        int64_t us = std::max<int64_t>(0, lateness.count());
+        buckets[std::min<int64_t>(kBuckets - 1, us / kBucketWidth.count())]++;
+        count++;
+        int64_t seen = max_us;
+        while (us > seen && !max_us.compare_exchange_weak(seen, us)) {
+        }
+    }
+
+    double percentileUs(double fraction) const {
+        uint64_t target = static_cast<uint64_t>(fraction * count);
+        uint64_t seen = 0;
+        for (int i = 0; i < kBuckets; i++) {
+            seen += buckets[i];
+            if (seen > target) {
+                return static_cast<double>((i + 1) * kBucketWidth.count());
+            }
+        }
+        return static_cast<double>(max_us);
+    }
+};
+
+// A game that wakes once per cooldown period, as one with a piece always
+// cooling does, and records how late each wake-up is.
+struct SimulatedGame {
+    Scheduler* scheduler = nullptr;
+    Histogram* lateness = nullptr;
+    const std::atomic<bool>* stopping = nullptr;
+    Clock::time_point due;
+
+    void arm() {
+        scheduler->schedule(due, [this] { wake(); });
+    }
+
+    void wake() {
+        lateness->add(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - due));
+        if (!*stopping) {
+            due += std::chrono::milliseconds(100);
+            arm();
+        }
+    }
+};
+
+}
+
+BENCHMARK(SchedulerJitter) {
+    const auto window = std::chrono::seconds(2);
+    int threads = std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, 4);
+
+    for (int games : {1000, 10000, 100000}) {
+        Histogram lateness;
+        std::atomic<bool> stopping(false);
+        std::vector<SimulatedGame> simulated(games);
+        std::mt19937 rng(games);
+        std::uniform_int_distribution<int> phase_us(0, 99999);
+
+        std::clock_t cpu_start;
+        Clock::time_point wall_start;
+        {
+            Scheduler scheduler(threads);
+            wall_start = Clock::now();
+            for (auto& game : simulated) {
+                game.scheduler = &scheduler;
+                game.lateness = &lateness;
+                game.stopping = &stopping;
+                game.due = wall_start + std::chrono::milliseconds(50) + std::chrono::microseconds(phase_us(rng));
+                game.arm();
+            }
+            cpu_start = std::clock();
+            std::this_thread::sleep_until(wall_start + window);
+            stopping = true;
+        }
+        double cpu_seconds = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+        double wall_seconds = std::chrono::duration<double>(Clock::now() - wall_start).count();
+
+        std::string prefix = std::to_string(games) + " games ";
+        reportValue(prefix + "wake-ups/sec", lateness.count / wall_seconds, "/s");
+        reportValue(prefix + "lateness p50", lateness.percentileUs(0.50), "us");
+        reportValue(prefix + "lateness p99", lateness.percentileUs(0.99), "us");
+        reportValue(prefix + "lateness max", static_cast<double>(lateness.max_us), "us");
+        reportValue(prefix + "CPU on " + std::to_string(threads) + " threads", 100.0 * cpu_seconds / wall_seconds,
+                    "% of a core");
+    }
+}
+
+BENCHMARK(TimerTickLateness) {
+    // Ticks of 10 ms for one second, idle and with every core kept busy.
+    for (bool loaded : {false, true}) {
+        for (auto policy : {Timer::OverrunPolicy::CATCH_UP, Timer::OverrunPolicy::SKIP}) {
+            std::atomic<bool> stop_load(false);
+            std::vector<std::thread> load;
+            if (loaded) {
+                for (unsigned i = 0; i < std::max(1u, std::thread::hardware_concurrency()); i++) {
+                    load.emplace_back([&stop_load] {
+                        uint64_t spin = 0;
+                        while (!stop_load) {
+                            keepResult(++spin);
+                        }
+                    });
+                }
+            }
+
+            Timer timer;
+            timer.setTickRate(10);
+            timer.setPeriodic(true, policy);
+            timer.start([] {});
+            std::this_thread::sleep_for(std::chrono::seconds(1));
+            timer.stop();
+            stop_load = true;
+            for (auto& thread : load) {
+                thread.join();
+            }
+
+            Timer::Stats stats = timer.stats();
+            std::string prefix = std::string(loaded ? "loaded " : "idle ") +
+                                 (policy == Timer::OverrunPolicy::SKIP ? "skip " : "catch-up ");
+            reportValue(prefix + "lateness p50", static_cast<double>(stats.percentile(0.50).count()), "us");
+            reportValue(prefix + "lateness p99", static_cast<double>(stats.percentile(0.99).count()), "us");
+            reportValue(prefix + "lateness max", static_cast<double>(stats.max_lateness.count()), "us");
+            reportValue(prefix + "missed/late ticks", static_cast<double>(stats.missed_ticks + stats.late_ticks),
+                        "ticks");
+        }
+    }
+}
@@ -0,0 +1,234 @@
+#include "bench_util.h"
+#include "../bot/ai_player.h"
+#include "../bot/mcts.h"
+#include "../bot/search.h"
+#include "../core/static_exchange.h"
+#include <functional>
+#include <memory>
+#include <thread>
+
+namespace {
+
+const char* const kPositions[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR",
+        "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R",
+        "r3k2r/pp1n1ppp/2p1pn2/q2p4/2PP4/2N1PN2/PPQ2PPP/R3KB1R",
+};
+
+struct ScalingSample {
+    double seconds = 0;
+    uint64_t nodes = 0;
+};
+
+// Fixed-depth search of every position with a fresh table each time, so
+// thread counts are compared on the same work.
+ScalingSample searchAll(int threads, int depth) {
+    ScalingSample sample;
+    for (const char* fen : kPositions) {
+        Board board;
+        board.setupFromFEN(fen);
+        TranspositionTable table(16);
+        SearchLimits limits;
+        limits.max_depth = depth;
+        SearchResult result = searchParallel(board, PlayerColor::WHITE, 10, 10, limits, &table, threads);
+        sample.seconds += std::chrono::duration<double>(result.elapsed).count();
+        sample.nodes += result.nodes;
+    }
+    return sample;
+}
+
+// 1, 2, 4, ... and finally every hardware thread.
+std::vector<int> threadCounts() {
+    int max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<int> counts;
+    for (int threads = 1; threads < max_threads; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(max_threads);
+    return counts;
+}
+
+}
+
+BENCHMARK(LazySmpScaling) {
+    const int depth = 5;
+    ScalingSample baseline;
+    for (int threads : threadCounts()) {
+        ScalingSample sample = searchAll(threads, depth);
+        if (threads == 1) {
+            baseline = sample;
+        }
+        std::string prefix = std::to_string(threads) + " threads ";
+        reportValue(prefix + "time to depth " + std::to_string(depth), sample.seconds * 1000.0, "ms");
+        reportValue(prefix + "nodes/sec", sample.nodes / sample.seconds, "nodes/s");
+        reportValue(prefix + "speedup", baseline.seconds / sample.seconds, "x");
+    }
+}
+
+BENCHMARK(MctsPlayoutRate) {
+    for (int threads : threadCounts()) {
+        double playouts = 0;
+        double seconds = 0;
+        for (const char* fen : kPositions) {
+            Board board;
+            board.setupFromFEN(fen);
+            Mcts mcts(PlayerColor::WHITE, 10, 10);
+            MctsLimits limits;
+            limits.max_playouts = 20000;
+            limits.threads = threads;
+            MctsResult result = mcts.run(board, limits);
+            playouts += static_cast<double>(result.playouts);
+            seconds += std::chrono::duration<double>(result.elapsed).count();
+        }
+        reportValue(std::to_string(threads) + " threads playouts/sec", playouts / seconds, "playouts/s");
+    }
+}
+
+BENCHMARK(IncrementalEvaluation) {
+    Board board;
+    board.setupFromFEN(kPositions[2]);
+    const int64_t iterations = 2000000;
+    double recompute_ns = measureNs(iterations, [&]() {
+        keepResult(board.computePsqScore(PlayerColor::WHITE) - board.computePsqScore(PlayerColor::BLACK));
+    });
+    double incremental_ns = measureNs(iterations, [&]() {
+        keepResult(Search::evaluate(board, PlayerColor::WHITE));
+    });
+    reportResult("full recompute", recompute_ns);
+    reportResult("incremental", incremental_ns);
+    reportRatio("incremental vs recompute", recompute_ns, incremental_ns);
+
+    SearchLimits limits;
+    limits.max_depth = 5;
+    Search search(PlayerColor::WHITE, 10, 10);
+    SearchResult result = search.run(board, limits);
+    reportValue("search nodes/sec", result.nodes / std::chrono::duration<double>(result.elapsed).count(),
+                "nodes/s");
+}
+
+BENCHMARK(StaticExchange) {
+    MoveValidator validator;
+    for (const char* fen : kPositions) {
+        Board board;
+        board.setupFromFEN(fen);
+        std::vector<Move> moves;
+        validator.generateMoves(board, PlayerColor::WHITE, moves);
+        const int64_t rounds = 20000;
+        double ns = measureNs(rounds, [&]() {
+            int total = 0;
+            for (const Move& move : moves) {
+                total += eval::staticExchange(board, move.piece_id, move.to);
+            }
+            keepResult(total);
+        });
+        reportResult(std::to_string(moves.size()) + " moves, per move", ns / static_cast<double>(moves.size()));
+    }
+}
+
+namespace {
+
+using Mover = std::function<std::optional<Move>(const Board&, PlayerColor)>;
+
+// One racing game on a bare board: each interval White then Black may move
+// a ready piece, then every cooldown runs down by `tick_step`. Returns +1,
+// 0 or -1 from White's side; unfinished games after `max_intervals` are draws.
+int playGame(const char* fen, const Mover& white, const Mover& black, int cooldown, int tick_step,
+             int max_intervals) {
+    Board board;
+    board.setupFromFEN(fen);
+    for (int interval = 0; interval < max_intervals; interval++) {
+        for (PlayerColor side : {PlayerColor::WHITE, PlayerColor::BLACK}) {
+            std::optional<Move> move = (side == PlayerColor::WHITE ? white : black)(board, side);
+            if (move) {
+                board.makeMove(move->piece_id, move->to, cooldown);
+            }
+            if (!board.pieces(opponentColor(side), PieceType::KING)) {
+                return side == PlayerColor::WHITE ? 1 : -1;
+            }
+        }
+        board.decrementCooldowns();
+        board.advanceCooldowns(tick_step - 1);
+    }
+    return 0;
+}
+
+Mover searchMover(const nnue::Network* network, int depth, int cooldown) {
+    return [network, depth, cooldown](const Board& position, PlayerColor side) {
+        Board board = position;
+        Search search(side, cooldown, cooldown);
+        SearchLimits limits;
+        limits.max_depth = depth;
+        limits.tick_step = 10;
+        limits.network = network;
+        return search.run(board, limits).best_move;
+    };
+}
+
+Mover heuristicMover() {
+    auto players = std::make_shared<std::array<AIPlayer, kColorCount>>(std::array<AIPlayer, kColorCount>{
+            AIPlayer(AIDifficulty::EASY, PlayerColor::WHITE, AIEngine::HEURISTIC),
+            AIPlayer(AIDifficulty::EASY, PlayerColor::BLACK, AIEngine::HEURISTIC)});
+    return [players](const Board& board, PlayerColor side) {
+        return (*players)[colorIndex(side)].getBestMove(board, 10, 10, SearchLimits::Clock::time_point::max());
+    };
+}
+
+// Score of `candidate` against `opponent` over both colors of every opening,
+// as wins + draws / 2 out of the games played.
+double matchScore(const Mover& candidate, const Mover& opponent) {
+    const int cooldown = 10;
+    double points = 0;
+    int games = 0;
+    for (const char* fen : kPositions) {
+        points += (1 + playGame(fen, candidate, opponent, cooldown, 10, 120)) / 2.0;
+        points += (1 - playGame(fen, opponent, candidate, cooldown, 10, 120)) / 2.0;
+        games += 2;
+    }
+    return points / games;
+}
+
+}
+
+BENCHMARK(NnueEvaluation) {
+    nnue::Network network = nnue::Network::fromPieceSquare();
+    Board board;
+    board.setupFromFEN(kPositions[2]);
+
+    double psq_ns = measureNs(2000000, [&]() {
+        keepResult(Search::evaluate(board, PlayerColor::WHITE));
+    });
+    reportValue("piece-square evals/sec", 1e9 / psq_ns, "evals/s");
+
+    nnue::SimdBackend original = nnue::simdBackend();
+    for (nnue::SimdBackend backend : {nnue::SimdBackend::SCALAR, nnue::SimdBackend::SSE2, nnue::SimdBackend::AVX2}) {
+        if (!nnue::setSimdBackend(backend)) {
+            continue;
+        }
+        const char* name = backend == nnue::SimdBackend::AVX2 ? "avx2" :
+                           backend == nnue::SimdBackend::SSE2 ? "sse2" : "scalar";
+        double full_ns = measureNs(20000, [&]() {
+            keepResult(nnue::evaluate(network, board, PlayerColor::WHITE));
+        });
+
+        // A quiet move, then its undo: two feature updates before each evaluation.
+        uint32_t knight = board.pieceIdAt(squareIndex(2, 2));
+        nnue::Accumulator accumulator;
+        accumulator.reset(network, board);
+        double incremental_ns = measureNs(200000, [&]() {
+            MoveUndo undo = board.makeMove(knight, {4, 1});
+            accumulator.refresh(network, board);
+            int score = accumulator.evaluate(network, PlayerColor::WHITE);
+            board.unmakeMove(undo);
+            accumulator.refresh(network, board);
+            keepResult(score + accumulator.evaluate(network, PlayerColor::WHITE));
+        }) / 2.0;
+        reportValue(std::string(name) + " full refresh evals/sec", 1e9 / full_ns, "evals/s");
+        reportValue(std::string(name) + " incremental evals/sec", 1e9 / incremental_ns, "evals/s");
+    }
+    nnue::setSimdBackend(original);
+
+    reportValue("network search vs heuristic", matchScore(searchMover(&network, 2, 10), heuristicMover()) * 100.0,
+                "% score");
+    reportValue("piece-square search vs heuristic",
+                matchScore(searchMover(nullptr, 2, 10), heuristicMover()) * 100.0, "% score");
+}
@@ -0,0 +1,77 @@
+#include "bench_util.h"
+#include "../core/sliding_attacks.h"
+#include <random>
+
+namespace {
+
+// Square-by-square walk to every target, as the old isPathClear() did.
+Bitboard walkQueen(int square, Bitboard occupied) {
+    Position from = squarePosition(square);
+    Bitboard result = 0;
+    for (int target = 0; target < kSquareCount; target++) {
+        Position to = squarePosition(target);
+        int row_diff = to.row - from.row;
+        int col_diff = to.col - from.col;
+        bool aligned = row_diff == 0 || col_diff == 0 || row_diff == col_diff || row_diff == -col_diff;
+        if (target == square || !aligned) {
+            continue;
+        }
+        int row_dir = (row_diff > 0) - (row_diff < 0);
+        int col_dir = (col_diff > 0) - (col_diff < 0);
+        Position current = {from.row + row_dir, from.col + col_dir};
+        bool clear = true;
+        while (current != to) {
+            if (occupied & squareBit(current)) {
+                clear = false;
+                break;
+            }
+            current.row += row_dir;
+            current.col += col_dir;
+        }
+        if (clear) {
+            result |= squareBit(target);
+        }
+    }
+    return result;
+}
+
+}
+
+BENCHMARK(SlidingAttackLookup) {
+    std::mt19937_64 rng(7);
+    std::vector<Bitboard> occupancies;
+    for (int i = 0; i < 256; i++) {
+        occupancies.push_back(rng() & rng());
+    }
+
+    auto sweep = [&](Bitboard (*lookup)(int, Bitboard)) {
+        Bitboard acc = 0;
+        for (Bitboard occupied : occupancies) {
+            for (int square = 0; square < kSquareCount; square++) {
+                acc ^= lookup(square, occupied);
+            }
+        }
+        keepResult(acc);
+    };
+    const double queries = 256.0 * kSquareCount;
+
+    double walk_ns = measureNs(20, [&] { sweep(walkQueen); }) / queries;
+    double magic_ns = measureNs(200, [&] {
+        sweep([](int square, Bitboard occupied) {
+            return attacks::rookAttacksMagic(square, occupied) | attacks::bishopAttacksMagic(square, occupied);
+        });
+    }) / queries;
+    reportResult("queen path walk", walk_ns);
+    reportResult("queen magic lookup", magic_ns);
+    reportRatio("magic speedup", walk_ns, magic_ns);
+
+    if (attacks::pextSupported()) {
+        double pext_ns = measureNs(200, [&] {
+            sweep([](int square, Bitboard occupied) {
+                return attacks::rookAttacksPext(square, occupied) | attacks::bishopAttacksPext(square, occupied);
+            });
+        }) / queries;
+        reportResult("queen pext lookup", pext_ns);
+        reportRatio("pext speedup", walk_ns, pext_ns);
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal self-registering benchmark harness; no external dependency.
+struct Benchmark {
+    std::string name;
+    std::function<void()> run;
+};
+
+std::vector<Benchmark>& benchmarkRegistry();
+
+struct BenchmarkRegistrar {
+    BenchmarkRegistrar(const char* name, std::function<void()> run) {
+        benchmarkRegistry().push_back({name, std::move(run)});
+    }
+};
+
+#define BENCHMARK(name) \
+    static void name(); \
+    static BenchmarkRegistrar name##_registrar(#name, name); \
+    static void name()
+
+// Keeps a computed value alive so the optimiser cannot drop the work.
+template <typename T>
+void keepResult(const T& value) {
+    static volatile T sink;
+    sink = value;
+    (void)sink;
+}
+
+// Runs fn() `iterations` times and returns the mean wall time per call in ns.
+template <typename Fn>
+double measureNs(int64_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int64_t i = 0; i < iterations; i++) {
+        fn();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+}
+
+void reportResult(const std::string& label, double ns_per_op);
+void reportRatio(const std::string& label, double baseline_ns, double optimized_ns);
+void reportValue(const std::string& label, double value, const std::string& unit);
@@ -1,36 +1,109 @@
 #include "ai_player.h"
+#include "../core/attack_tables.h"
+#include "../core/piece_square_tables.h"
+#include "../core/static_exchange.h"
 #include <algorithm>
 #include <iostream>
 #include <cmath>
 
-AIPlayer::AIPlayer(AIDifficulty difficulty, PlayerColor color)
+namespace {
+
+// Heuristic weights in pawns. Kings are not material, so they get their
+// own weights where they matter.
+constexpr double kKingPressure = 12.0;
+constexpr double kKingProtection = 5.0;
+// Scales a centipawn placement delta to the heuristic's pawn units.
+constexpr double kPlacementWeight = 0.02;
+
+double materialValue(PieceType type) {
+    return eval::kPieceValues[typeIndex(type)] / 100.0;
+}
+
+}
+
+AIPlayer::AIPlayer(AIDifficulty difficulty, PlayerColor color, std::optional<AIEngine> engine)
         : difficulty_(difficulty),
           color_(color),
           rng_(std::random_device()()),
-          move_randomness_(3) {
+          move_randomness_(3),
+          engine_(AIEngine::HEURISTIC),
+          engine_override_(engine),
+          think_time_(0),
+          hash_megabytes_(16),
+          threads_(1) {
     setDifficulty(difficulty);
 }
 
 void AIPlayer::setDifficulty(AIDifficulty difficulty) {
     difficulty_ = difficulty;
+    AIEngine engine = AIEngine::ALPHA_BETA;
     switch (difficulty) {
         case AIDifficulty::EASY:
             move_randomness_ = 5;
+            engine = AIEngine::HEURISTIC;
+            search_limits_.max_depth = 2;
+            search_limits_.tick_step = 40;
+            search_limits_.max_nodes = 5000;
+            mcts_limits_.max_playouts = 500;
+            mcts_limits_.tick_step = 40;
+            think_time_ = std::chrono::milliseconds(20);
             break;
         case AIDifficulty::MEDIUM:
             move_randomness_ = 3;
+            search_limits_.max_depth = 3;
+            search_limits_.tick_step = 40;
+            search_limits_.max_nodes = 20000;
+            mcts_limits_.max_playouts = 3000;
+            mcts_limits_.tick_step = 40;
+            think_time_ = std::chrono::milliseconds(50);
             break;
         case AIDifficulty::HARD:
             move_randomness_ = 2;
+            search_limits_.max_depth = 6;
+            search_limits_.tick_step = 25;
+            search_limits_.max_nodes = 200000;
+            mcts_limits_.max_playouts = 15000;
+            mcts_limits_.tick_step = 25;
+            think_time_ = std::chrono::milliseconds(150);
             break;
         case AIDifficulty::EXPERT:
             move_randomness_ = 1;
+            search_limits_.max_depth = 32;
+            search_limits_.tick_step = 10;
+            search_limits_.max_nodes = 1000000;
+            mcts_limits_.max_playouts = 60000;
+            mcts_limits_.tick_step = 10;
+            think_time_ = std::chrono::milliseconds(400);
             break;
     }
+    engine_ = engine_override_.value_or(engine);
+}
+
+void AIPlayer::setHashSize(size_t megabytes) {
+    hash_megabytes_ = megabytes;
+    if (table_) {
+        table_->resize(megabytes);
+    }
 }
 
 std::optional<Move> AIPlayer::getBestMove(const Game &game) {
-    auto moves = evaluateAllMoves(game);
+    return getBestMove(game, SearchLimits::Clock::now() + think_time_);
+}
+
+std::optional<Move> AIPlayer::getBestMove(const Game &game, SearchLimits::Clock::time_point deadline) {
+    return getBestMove(game.getBoard(), game.getWhiteCooldown(), game.getBlackCooldown(), deadline);
+}
+
+std::optional<Move> AIPlayer::getBestMove(const Board &position, int white_cooldown, int black_cooldown,
+                                          SearchLimits::Clock::time_point deadline, const std::atomic<bool> *cancel) {
+    if (engine_ == AIEngine::ALPHA_BETA) {
+        return searchBestMove(position, white_cooldown, black_cooldown, deadline, cancel);
+    }
+    if (engine_ == AIEngine::MCTS) {
+        return mctsBestMove(position, white_cooldown, black_cooldown, deadline, cancel);
+    }
+
+    auto moves = evaluateAllMoves(position);
 
     if (moves.empty()) {
         return std::nullopt;
@@ -48,42 +121,67 @@ std::optional<Move> AIPlayer::getBestMove(const Game &game) {
     return best_move;
 }
 
-std::vector<AIPlayer::MoveScore> AIPlayer::evaluateAllMoves(const Game &game) {
+std::optional<Move> AIPlayer::searchBestMove(const Board &position, int white_cooldown, int black_cooldown,
+                                             SearchLimits::Clock::time_point deadline,
+                                             const std::atomic<bool> *cancel) {
+    if (!table_) {
+        table_ = std::make_shared<TranspositionTable>(hash_megabytes_);
+    }
+    table_->newSearch();
+
+    Board board = position;
+    SearchLimits limits = search_limits_;
+    limits.deadline = std::min(limits.deadline, deadline);
+    limits.cancel = cancel;
+    limits.network = network_.get();
+    search_state_.update(board);
+    last_search_ = searchParallel(board, color_, white_cooldown, black_cooldown, limits, table_.get(), threads_,
+                                  &search_state_);
+    search_state_.record(last_search_);
+    return last_search_.best_move;
+}
+
+std::optional<Move> AIPlayer::mctsBestMove(const Board &position, int white_cooldown, int black_cooldown,
+                                           SearchLimits::Clock::time_point deadline,
+                                           const std::atomic<bool> *cancel) {
+    Mcts mcts(color_, white_cooldown, black_cooldown);
+    MctsLimits limits = mcts_limits_;
+    limits.threads = threads_;
+    limits.deadline = std::min(limits.deadline, deadline);
+    limits.cancel = cancel;
+    limits.seed = rng_();
+    last_mcts_ = mcts.run(position, limits);
+    return last_mcts_.best_move;
+}
+
+std::vector<AIPlayer::MoveScore> AIPlayer::evaluateAllMoves(const Board &position) {
     std::vector<MoveScore> moves;
-    const Board &board = game.getBoard();
+    Board board = position;
 
-    auto pieces = board.getPlayerPieces(color_, false);
+    std::vector<Move> candidates;
     MoveValidator validator;
-    for (const auto &piece: pieces) {
-        if (piece.cooldown_ticks_remaining > 0) {
-            continue;
-        }
-        auto valid_moves = validator.getValidMoves(board, piece.id);
-        for (const auto &target: valid_moves) {
-            MoveScore move_score;
-            move_score.move.piece_id = piece.id;
-            move_score.move.from = piece.position;
-            move_score.move.to = target;
-            move_score.move.timestamp = 0;
-            move_score.score = evaluateMove(game, piece, target);
-            moves.push_back(move_score);
-        }
+    validator.generateMoves(board, color_, candidates);
+
+    moves.reserve(candidates.size());
+    for (const auto &candidate: candidates) {
+        Piece piece = *board.findPiece(candidate.piece_id);
+        MoveScore move_score;
+        move_score.move = candidate;
+        move_score.score = evaluateMove(board, piece, candidate.to);
+        moves.push_back(move_score);
     }
     return moves;
 }
 
-double AIPlayer::evaluateMove(const Game &game, const Piece &piece, Position target) {
+double AIPlayer::evaluateMove(Board &board, const Piece &piece, Position target) {
     double score = 0.0;
-    if (piece.type == PieceType::PAWN) {
-        score += getRowScore(piece, target);
-    }
-    if (piece.type == PieceType::KNIGHT || piece.type == PieceType::BISHOP) {
-        score += getColScore(piece, target);
-    }
-    score += getCaptureScore(game, piece, target) * 8.0;
-    score += getPressureScore(game, piece, target) * 1.5;
-    score -= getVulnerabilityScore(game, piece, target) * 1.8;
-    score += getProtectionScore(game, piece, target) * 1.2;
+    double exchange = getExchangeScore(board, piece, target);
+    score += exchange * (exchange > 0 ? 8.0 : 1.8);
+    score += getPlacementScore(piece, target);
+
+    MoveUndo undo = board.makeMove(piece.id, target);
+    score += getPressureScore(board, piece) * 1.5;
+    score += getProtectionScore(board, piece) * 1.2;
     if (piece.type == PieceType::KING && std::abs(target.col - piece.position.col) == 2) {
         score += 3.0;
     }
@@ -92,201 +190,74 @@ double AIPlayer::evaluateMove(const Game &game, const Piece &piece, Position tar
          (piece.color == PlayerColor::BLACK && target.row == 0))) {
         score += 9.0;
     }
-    double king_threat = getKingThreatScore(game, piece, target);
+    double king_threat = getKingThreatScore(board, piece);
     score -= king_threat * 1.8;
-    return score;
-}
 
-double AIPlayer::getRowScore(const Piece &piece, Position target) {
-    if (piece.type != PieceType::PAWN) {
-        return 0.0;
-    }
-    int direction = (piece.color == PlayerColor::WHITE) ? 1 : -1;
-    int progress = (target.row - piece.position.row) * direction;
-    double base_score = progress * 0.1;
-    int distance_to_promotion = (piece.color == PlayerColor::WHITE) ? (7 - target.row) : target.row;
-    double promotion_score = (7 - distance_to_promotion) * 0.05;
-    return base_score + promotion_score;
+    board.unmakeMove(undo);
+    return score;
 }
 
-double AIPlayer::getColScore(const Piece &piece, Position target) {
-    double col_center = std::abs(3.5 - target.col);
-    double row_center = std::abs(3.5 - target.row);
-    return 0.1 * (4 - col_center) + 0.1 * (4 - row_center);
+double AIPlayer::getPlacementScore(const Piece &piece, Position target) {
+    int delta = eval::pieceSquare(piece.color, piece.type, squareIndex(target)) -
+                eval::pieceSquare(piece.color, piece.type, squareIndex(piece.position));
+    return delta * kPlacementWeight;
 }
 
-double AIPlayer::getCaptureScore(const Game &game, const Piece &piece, Position target) {
-    const Board &board = game.getBoard();
-    auto target_piece = board.getPieceAt(target);
-    if (!target_piece) {
-        return 0.0;
-    }
-    double piece_values[] = {
-            1.0,
-            3.0,
-            3.2,
-            5.0,
-            9.0,
-            100.0
-    };
-    return piece_values[static_cast<int>(target_piece->type)];
+double AIPlayer::getExchangeScore(const Board &board, const Piece &piece, Position target) {
+    return eval::staticExchange(board, piece.id, target) / 100.0;
 }
 
-double AIPlayer::getPressureScore(const Game &game, const Piece &piece, Position target) {
-    Board temp_board = game.getBoard();
-    temp_board.movePiece(piece.id, target);
-    auto moved_piece = temp_board.getPieceById(piece.id);
+double AIPlayer::getPressureScore(const Board &board, const Piece &piece) {
+    auto moved_piece = board.getPieceById(piece.id);
     if (!moved_piece) {
         return 0.0;
     }
     MoveValidator validator;
-    auto new_moves = validator.getValidMoves(temp_board, moved_piece->id);
+    auto new_moves = validator.getValidMoves(board, moved_piece->id);
     double pressure_score = 0.0;
     for (const auto &pos: new_moves) {
-        auto threatened_piece = temp_board.getPieceAt(pos);
+        auto threatened_piece = board.getPieceAt(pos);
         if (threatened_piece && threatened_piece->color != piece.color) {
-            switch (threatened_piece->type) {
-                case PieceType::PAWN:
-                    pressure_score += 1.0;
-                    break;
-                case PieceType::KNIGHT:
-                case PieceType::BISHOP:
-                    pressure_score += 3.0;
-                    break;
-                case PieceType::ROOK:
-                    pressure_score += 5.0;
-                    break;
-                case PieceType::QUEEN:
-                    pressure_score += 9.0;
-                    break;
-                case PieceType::KING:
-                    pressure_score += 12.0;
-                    break;
-            }
+            pressure_score += threatened_piece->type == PieceType::KING
+                    ? kKingPressure : materialValue(threatened_piece->type);
         }
     }
     return pressure_score * 0.1;
 }
 
-double AIPlayer::getVulnerabilityScore(const Game &game, const Piece &piece, Position target) {
-    Board temp_board = game.getBoard();
-    temp_board.movePiece(piece.id, target);
-    PlayerColor enemy_color = (piece.color == PlayerColor::WHITE) ? PlayerColor::BLACK : PlayerColor::WHITE;
-    auto enemy_pieces = temp_board.getPlayerPieces(enemy_color, false);
-    double piece_value = 0.0;
-    switch (piece.type) {
-        case PieceType::PAWN:
-            piece_value = 1.0;
-            break;
-        case PieceType::KNIGHT:
-        case PieceType::BISHOP:
-            piece_value = 3.0;
-            break;
-        case PieceType::ROOK:
-            piece_value = 5.0;
-            break;
-        case PieceType::QUEEN:
-            piece_value = 9.0;
-            break;
-        case PieceType::KING:
-            piece_value = 100.0;
-            break;
-    }
-    MoveValidator validator;
-    bool is_threatened = false;
-    for (const auto &enemy: enemy_pieces) {
-        if (enemy.cooldown_ticks_remaining > 0) {
-            continue;
-        }
-        auto enemy_moves = validator.getValidMoves(temp_board, enemy.id);
-        for (const auto &enemy_move: enemy_moves) {
-            if (enemy_move == target) {
-                is_threatened = true;
-                break;
-            }
-        }
-        if (is_threatened) break;
-    }
-    return is_threatened ? piece_value : 0.0;
-}
-
-double AIPlayer::getProtectionScore(const Game &game, const Piece &piece, Position target) {
-    Board temp_board = game.getBoard();
-    temp_board.movePiece(piece.id, target);
-    auto moved_piece = temp_board.getPieceById(piece.id);
+double AIPlayer::getProtectionScore(const Board &board, const Piece &piece) {
+    const Piece *moved_piece = board.findPiece(piece.id);
     if (!moved_piece) {
         return 0.0;
     }
-    auto friendly_pieces = temp_board.getPlayerPieces(color_, false);
+    auto friendly_pieces = board.getPlayerPieces(color_, false);
     MoveValidator validator;
-    auto new_moves = validator.getValidMoves(temp_board, moved_piece->id);
+    Bitboard new_moves = validator.getMoveTargets(board, *moved_piece);
     double protection_score = 0.0;
     for (const auto &friendly: friendly_pieces) {
         if (friendly.id == piece.id) {
             continue;
         }
-        for (const auto &move_pos: new_moves) {
-            int row_diff = std::abs(move_pos.row - friendly.position.row);
-            int col_diff = std::abs(move_pos.col - friendly.position.col);
-            if (row_diff <= 1 && col_diff <= 1) {
-                switch (friendly.type) {
-                    case PieceType::PAWN:
-                        protection_score += 0.5;
-                        break;
-                    case PieceType::KNIGHT:
-                    case PieceType::BISHOP:
-                        protection_score += 1.5;
-                        break;
-                    case PieceType::ROOK:
-                        protection_score += 2.5;
-                        break;
-                    case PieceType::QUEEN:
-                        protection_score += 4.5;
-                        break;
-                    case PieceType::KING:
-                        protection_score += 5.0;
-                        break;
-                }
-                break;
-            }
+        if (!(attacks::kingAttacks(squareIndex(friendly.position)) & new_moves)) {
+            continue;
         }
+        protection_score += friendly.type == PieceType::KING
+                ? kKingProtection : materialValue(friendly.type) / 2.0;
     }
     return protection_score * 0.1;
 }
 
-double AIPlayer::getKingThreatScore(const Game &game, const Piece &piece, Position target) {
+double AIPlayer::getKingThreatScore(const Board &board, const Piece &piece) {
     if (piece.type == PieceType::KING) {
         return 0.0;
     }
-    Board temp_board = game.getBoard();
-    temp_board.movePiece(piece.id, target);
-    PlayerColor friendly_color = piece.color;
-    Position king_pos;
-    bool king_found = false;
-    auto friendly_pieces = temp_board.getPlayerPieces(friendly_color, false);
-    for (const auto &p: friendly_pieces) {
-        if (p.type == PieceType::KING) {
-            king_pos = p.position;
-            king_found = true;
-            break;
-        }
-    }
-    if (!king_found) {
+    Bitboard king = board.pieces(piece.color, PieceType::KING);
+    if (!king) {
         return 0.0;
     }
     PlayerColor enemy_color = (piece.color == PlayerColor::WHITE) ? PlayerColor::BLACK : PlayerColor::WHITE;
-    auto enemy_pieces = temp_board.getPlayerPieces(enemy_color, false);
-    MoveValidator validator;
-    for (const auto &enemy: enemy_pieces) {
-        if (enemy.cooldown_ticks_remaining > 0) {
-            continue;
-        }
-        auto enemy_moves = validator.getValidMoves(temp_board, enemy.id);
-        for (const auto &move_pos: enemy_moves) {
-            if (move_pos == king_pos) {
-                return 100.0;
-            }
-        }
+    if (board.attackedBy(enemy_color, true) & king) {
+        return 100.0;
     }
     return 0.0;
 }
@@ -2,39 +2,108 @@
 
 #include "../core/chess_types.h"
 #include "../core/game.h"
+#include "mcts.h"
+#include "search.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <vector>
 #include <optional>
 #include <random>
 
 class AIPlayer {
 public:
-    AIPlayer(AIDifficulty difficulty, PlayerColor color);
+    // `engine` overrides the engine the difficulty would pick; the
+    // difficulty still sets that engine's budget.
+    AIPlayer(AIDifficulty difficulty, PlayerColor color, std::optional<AIEngine> engine = std::nullopt);
 
+    // Uses the difficulty's think time as the budget.
     std::optional<Move> getBestMove(const Game& game);
+    // Anytime search: returns the best move of the last iteration that
+    // finished before `deadline`.
+    std::optional<Move> getBestMove(const Game& game, SearchLimits::Clock::time_point deadline);
+    // Same, on a detached snapshot. Setting `cancel` abandons the search.
+    std::optional<Move> getBestMove(const Board& position, int white_cooldown, int black_cooldown,
+                                    SearchLimits::Clock::time_point deadline,
+                                    const std::atomic<bool>* cancel = nullptr);
     void setDifficulty(AIDifficulty difficulty);
     void setMoveProbability(int ticks);
 
     AIDifficulty getDifficulty() const { return difficulty_; }
 
+    // Difficulty picks an engine and limits; these override that choice.
+    void setEngine(AIEngine engine) { engine_override_ = engine; engine_ = engine; }
+    AIEngine getEngine() const { return engine_; }
+    void setSearchLimits(const SearchLimits& limits) { search_limits_ = limits; }
+    const SearchLimits& getSearchLimits() const { return search_limits_; }
+    void setMctsLimits(const MctsLimits& limits) { mcts_limits_ = limits; }
+    const MctsLimits& getMctsLimits() const { return mcts_limits_; }
+    void setThinkTime(std::chrono::milliseconds think_time) { think_time_ = think_time; }
+    std::chrono::milliseconds getThinkTime() const { return think_time_; }
+
+    // The table persists across decisions and can be handed to other players
+    // or search threads. Created on first search at the configured size.
+    void setHashSize(size_t megabytes);
+    void setTranspositionTable(std::shared_ptr<TranspositionTable> table) { table_ = std::move(table); }
+    std::shared_ptr<TranspositionTable> getTranspositionTable() const { return table_; }
+
+    // Search threads for either engine (Lazy SMP or tree-parallel MCTS);
+    // 1 searches on the caller.
+    void setThreads(int threads) { threads_ = std::max(1, threads); }
+    int getThreads() const { return threads_; }
+
+    // Scores alpha-beta leaves with `network` instead of the piece-square
+    // sum; nullptr switches back.
+    void setNetwork(std::shared_ptr<const nnue::Network> network) { network_ = std::move(network); }
+    std::shared_ptr<const nnue::Network> getNetwork() const { return network_; }
+
+    // PV and reply table kept between decisions; see SearchState.
+    const SearchState& getSearchState() const { return search_state_; }
+
+    // Depth, node count and timing of the most recent search.
+    const SearchResult& getLastSearch() const { return last_search_; }
+    // Playouts, playouts/sec and timing of the most recent MCTS decision.
+    const MctsResult& getLastMcts() const { return last_mcts_; }
+
 private:
     AIDifficulty difficulty_;
     PlayerColor color_;
     std::mt19937 rng_;
     int move_randomness_;
+    AIEngine engine_;
+    std::optional<AIEngine> engine_override_;
+    SearchLimits search_limits_;
+    std::chrono::milliseconds think_time_;
+    SearchResult last_search_;
+    MctsLimits mcts_limits_;
+    MctsResult last_mcts_;
+    size_t hash_megabytes_;
+    int threads_;
+    SearchState search_state_;
+    std::shared_ptr<TranspositionTable> table_;
+    std::shared_ptr<const nnue::Network> network_;
+
+    std::optional<Move> searchBestMove(const Board& position, int white_cooldown, int black_cooldown,
+                                       SearchLimits::Clock::time_point deadline,
+                                       const std::atomic<bool>* cancel);
+    std::optional<Move> mctsBestMove(const Board& position, int white_cooldown, int black_cooldown,
+                                     SearchLimits::Clock::time_point deadline,
+                                     const std::atomic<bool>* cancel);
 
     struct MoveScore {
         Move move;
         double score;
     };
 
-    std::vector<MoveScore> evaluateAllMoves(const Game& game);
-    double evaluateMove(const Game& game, const Piece& piece, Position target);
+    std::vector<MoveScore> evaluateAllMoves(const Board& position);
+    double evaluateMove(Board& board, const Piece& piece, Position target);
 
-    double getRowScore(const Piece& piece, Position target);
-    double getColScore(const Piece& piece, Position target);
-    double getCaptureScore(const Game& game, const Piece& piece, Position target);
-    double getPressureScore(const Game& game, const Piece& piece, Position target);
-    double getVulnerabilityScore(const Game& game, const Piece& piece, Position target);
-    double getProtectionScore(const Game& game, const Piece& piece, Position target);
-    double getKingThreatScore(const Game& game, const Piece& piece, Position target);
+    // Piece-square delta of moving `piece` to `target`.
+    double getPlacementScore(const Piece& piece, Position target);
+    // Static exchange outcome of the move in pawns, cooling pieces excluded.
+    double getExchangeScore(const Board& board, const Piece& piece, Position target);
+    double getPressureScore(const Board& board, const Piece& piece);
+    double getProtectionScore(const Board& board, const Piece& piece);
+    double getKingThreatScore(const Board& board, const Piece& piece);
 };
@@ -0,0 +1,225 @@
+#include "ai_worker.h"
+#include "../utility/condition_wait.h"
+
+AIWorker::AIWorker(AIDifficulty difficulty, PlayerColor color, std::optional<AIEngine> engine)
+        : player_(difficulty, color, engine),
+          difficulty_(difficulty),
+          color_(color),
+          think_time_(player_.getThinkTime()),
+          next_id_(1),
+          latest_id_(0),
+          running_id_(0),
+          running_hash_(0),
+          running_ponder_(false),
+          cancel_(false),
+          running_(true) {
+    thread_ = std::thread(&AIWorker::workerLoop, this);
+}
+
+AIWorker::~AIWorker() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        pending_.reset();
+        cancel_ = true;
+    }
+    wake_.notify_one();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+AIWorker::Request AIWorker::snapshot(const Game& game, SearchLimits::Clock::time_point deadline) const {
+    return Request{0, game.getBoard(), game.getWhiteCooldown(), game.getBlackCooldown(), deadline, false};
+}
+
+uint64_t AIWorker::request(const Game& game, SearchLimits::Clock::time_point deadline) {
+    Request request = snapshot(game, deadline);
+    uint64_t hash = request.board.hash();
+    uint64_t id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = next_id_++;
+        request.id = id;
+        latest_id_ = id;
+
+        // Ponder hit, already finished: answer right away.
+        if (ponder_result_ && ponder_result_->position_hash == hash) {
+            AIMoveResult result = std::move(*ponder_result_);
+            ponder_result_.reset();
+            pending_.reset();
+            // A later ponder on some other projection is no use any more.
+            if (running_ponder_) {
+                cancel_ = true;
+            }
+            result.request_id = id;
+            completed_.push_back(std::move(result));
+            return id;
+        }
+        ponder_result_.reset();
+
+        // Ponder hit, still searching: it becomes this request's search as
+        // long as it will not overrun the request's deadline.
+        if (running_ponder_ && running_hash_ == hash && running_deadline_ <= deadline) {
+            running_ponder_ = false;
+            running_id_ = id;
+            pending_.reset();
+            return id;
+        }
+
+        pending_ = std::move(request);
+        if (running_id_ != 0) {
+            cancel_ = true;
+        }
+    }
+    wake_.notify_one();
+    return id;
+}
+
+uint64_t AIWorker::request(const Game& game) {
+    return request(game, SearchLimits::Clock::now() + think_time_);
+}
+
+void AIWorker::ponder(const Game& game, SearchLimits::Clock::time_point until) {
+    Request request = snapshot(game, until);
+    request.ponder = true;
+
+    // Project to the moment our first piece is ready again; that is the
+    // position we will be asked about if the opponent does nothing.
+    int wait_ticks = -1;
+    for (const Piece& piece : request.board.getPlayerPieces(color_)) {
+        if (wait_ticks < 0 || piece.cooldown_ticks_remaining < wait_ticks) {
+            wait_ticks = piece.cooldown_ticks_remaining;
+        }
+    }
+    for (int tick = 0; tick < wait_ticks; tick++) {
+        request.board.decrementCooldowns();
+    }
+    uint64_t hash = request.board.hash();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (busyLocked()) {
+            return;
+        }
+        if ((ponder_result_ && ponder_result_->position_hash == hash) ||
+            (running_ponder_ && running_hash_ == hash) ||
+            (pending_ && pending_->board.hash() == hash)) {
+            return;
+        }
+
+        ponder_result_.reset();
+        request.id = next_id_++;
+        pending_ = std::move(request);
+        if (running_id_ != 0) {
+            cancel_ = true;
+        }
+    }
+    wake_.notify_one();
+}
+
+void AIWorker::cancel() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.reset();
+    ponder_result_.reset();
+    latest_id_ = next_id_++;
+    if (running_id_ != 0) {
+        cancel_ = true;
+    }
+}
+
+void AIWorker::cancelIfStale(const Game& game) {
+    // Requests hash the board recounted to the current time, so compare
+    // against the same, not the snapshot's hash at publication.
+    uint64_t hash = game.positionHash();
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Ponder searches target a projected position; ponder() replaces them.
+    if (pending_ && !pending_->ponder && pending_->board.hash() != hash) {
+        pending_.reset();
+    }
+    if (running_id_ != 0 && !running_ponder_ && running_hash_ != hash) {
+        cancel_ = true;
+    }
+}
+
+std::optional<AIMoveResult> AIWorker::poll() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (completed_.empty()) {
+        return std::nullopt;
+    }
+    AIMoveResult result = std::move(completed_.front());
+    completed_.pop_front();
+    return result;
+}
+
+bool AIWorker::busy() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return busyLocked();
+}
+
+bool AIWorker::pondering() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return running_ponder_ || (pending_ && pending_->ponder);
+}
+
+bool AIWorker::busyLocked() const {
+    return (pending_ && !pending_->ponder) || (running_id_ != 0 && !running_ponder_);
+}
+
+bool AIWorker::stillApplies(const Game& game, const AIMoveResult& result) const {
+    Board board = game.getBoard();
+    if (!result.move || result.position_hash != board.hash()) {
+        return false;
+    }
+    const Piece* piece = board.findPiece(result.move->piece_id);
+    return piece && piece->color == color_ && piece->cooldown_ticks_remaining == 0 &&
+           validator_.isValidMove(board, result.move->piece_id, result.move->to);
+}
+
+bool AIWorker::apply(Game& game, const AIMoveResult& result) const {
+    if (!stillApplies(game, result)) {
+        return false;
+    }
+    return game.makeMove(result.move->piece_id, result.move->to);
+}
+
+void AIWorker::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        blockUntil(wake_, lock, [this] { return !running_ || pending_.has_value(); });
+        if (!running_) {
+            return;
+        }
+
+        Request request = std::move(*pending_);
+        pending_.reset();
+        running_id_ = request.id;
+        running_hash_ = request.board.hash();
+        running_deadline_ = request.deadline;
+        running_ponder_ = request.ponder;
+        cancel_ = false;
+        lock.unlock();
+
+        AIMoveResult result;
+        result.position_hash = request.board.hash();
+        result.move = player_.getBestMove(request.board, request.white_cooldown, request.black_cooldown,
+                                          request.deadline, &cancel_);
+        result.search = player_.getLastSearch();
+
+        lock.lock();
+        // A ponder search may have been adopted by a request meanwhile.
+        result.request_id = running_id_;
+        bool was_ponder = running_ponder_;
+        running_id_ = 0;
+        running_ponder_ = false;
+        // Superseded or cancelled searches are dropped instead of queued.
+        if (cancel_) {
+            continue;
+        }
+        if (was_ponder) {
+            ponder_result_ = std::move(result);
+        } else if (result.request_id == latest_id_) {
+            completed_.push_back(std::move(result));
+        }
+    }
+}
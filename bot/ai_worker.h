@@ -0,0 +1,93 @@
+#pragma once
+
+#include "ai_player.h"
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// A move found by the worker, tagged with the position it was searched on.
+struct AIMoveResult {
+    uint64_t request_id = 0;
+    uint64_t position_hash = 0;
+    std::optional<Move> move;
+    SearchResult search;
+};
+
+// Runs an AIPlayer on its own thread so the caller never blocks on search.
+// request() snapshots the game and hands it over; finished moves land in a
+// completion queue that the owning thread drains with poll(). A new request
+// or cancel() abandons whatever search is still running.
+//
+// While idle the worker can ponder: search the position it expects to be
+// asked about, i.e. the current one once its own first piece is off
+// cooldown. A request for that position is then answered from the finished
+// ponder result, or by adopting the ponder search still in flight.
+class AIWorker {
+public:
+    AIWorker(AIDifficulty difficulty, PlayerColor color, std::optional<AIEngine> engine = std::nullopt);
+    ~AIWorker();
+
+    AIWorker(const AIWorker&) = delete;
+    AIWorker& operator=(const AIWorker&) = delete;
+
+    uint64_t request(const Game& game, SearchLimits::Clock::time_point deadline);
+    // Uses the difficulty's think time as the budget.
+    uint64_t request(const Game& game);
+    void cancel();
+    // Starts (or keeps) pondering the game's position until `until`, the
+    // time the caller expects to request a move. No-op while busy.
+    void ponder(const Game& game, SearchLimits::Clock::time_point until);
+    // Cancels the running search if the game has moved past its snapshot.
+    void cancelIfStale(const Game& game);
+
+    std::optional<AIMoveResult> poll();
+    // True while a real request is queued or searching; pondering is idle.
+    bool busy() const;
+    bool pondering() const;
+
+    // True if `result` was searched on the game's current position and its
+    // move is still legal for the worker's side.
+    bool stillApplies(const Game& game, const AIMoveResult& result) const;
+    // Re-validates and applies a result; returns false if it was dropped.
+    bool apply(Game& game, const AIMoveResult& result) const;
+
+    AIDifficulty getDifficulty() const { return difficulty_; }
+    PlayerColor getColor() const { return color_; }
+
+private:
+    struct Request {
+        uint64_t id;
+        Board board;
+        int white_cooldown;
+        int black_cooldown;
+        SearchLimits::Clock::time_point deadline;
+        bool ponder;
+    };
+
+    Request snapshot(const Game& game, SearchLimits::Clock::time_point deadline) const;
+    bool busyLocked() const;
+    void workerLoop();
+
+    AIPlayer player_;
+    AIDifficulty difficulty_;
+    PlayerColor color_;
+    std::chrono::milliseconds think_time_;
+    MoveValidator validator_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::optional<Request> pending_;
+    std::deque<AIMoveResult> completed_;
+    uint64_t next_id_;
+    uint64_t latest_id_;
+    uint64_t running_id_;
+    uint64_t running_hash_;
+    SearchLimits::Clock::time_point running_deadline_;
+    bool running_ponder_;
+    std::optional<AIMoveResult> ponder_result_;
+    std::atomic<bool> cancel_;
+    bool running_;
+
+    std::thread thread_;
+};
@@ -0,0 +1,261 @@
+#include "mcts.h"
+#include "search.h"
+#include <cmath>
+#include <thread>
+
+namespace {
+
+const int kVictimValues[kPieceTypeCount] = {1, 3, 3, 5, 9, 100};
+
+}
+
+Mcts::Mcts(PlayerColor root_color, int white_cooldown, int black_cooldown)
+        : root_color_(root_color),
+          white_cooldown_(white_cooldown),
+          black_cooldown_(black_cooldown),
+          playouts_(0) {
+}
+
+MctsResult Mcts::run(const Board& board, const MctsLimits& limits) {
+    auto start = MctsLimits::Clock::now();
+    limits_ = limits;
+    playouts_ = 0;
+    root_ = makeNode(board);
+
+    MctsResult result;
+    if (!root_->terminal && root_->actions[0].size() > 1) {
+        auto worker = [this, &board](uint64_t seed) {
+            std::mt19937_64 rng(seed);
+            while (!shouldStop()) {
+                playout(board, rng);
+            }
+        };
+
+        int threads = std::max(1, limits.threads);
+        std::vector<std::thread> helpers;
+        helpers.reserve(threads - 1);
+        for (int i = 1; i < threads; i++) {
+            helpers.emplace_back(worker, limits.seed + i);
+        }
+        worker(limits.seed);
+        for (auto& helper : helpers) {
+            helper.join();
+        }
+
+        // The most visited action is the most robust choice.
+        const ActionStats* stats = root_->stats[0].get();
+        size_t best = 0;
+        for (size_t i = 1; i < root_->actions[0].size(); i++) {
+            if (stats[i].visits > stats[best].visits) {
+                best = i;
+            }
+        }
+        if (best != 0) {
+            result.best_move = root_->actions[0][best];
+        }
+        uint32_t visits = stats[best].visits;
+        result.value = visits ? static_cast<double>(stats[best].reward) / kRewardScale / visits : 0.0;
+    }
+
+    result.playouts = playouts_;
+    result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(MctsLimits::Clock::now() - start);
+    double seconds = std::chrono::duration<double>(result.elapsed).count();
+    result.playouts_per_second = seconds > 0 ? result.playouts / seconds : 0.0;
+    root_.reset();
+    return result;
+}
+
+std::unique_ptr<Mcts::Node> Mcts::makeNode(const Board& board) const {
+    auto node = std::make_unique<Node>();
+    if (auto reward = terminalReward(board)) {
+        node->terminal = true;
+        node->terminal_reward = *reward;
+        return node;
+    }
+
+    PlayerColor colors[2] = {root_color_, opponentColor(root_color_)};
+    for (int side = 0; side < 2; side++) {
+        std::vector<Move>& actions = node->actions[side];
+        actions.push_back(Move{0, {0, 0}, {0, 0}, 0});
+        validator_.generateMoves(board, colors[side], actions);
+        node->stats[side] = std::make_unique<ActionStats[]>(actions.size());
+    }
+    return node;
+}
+
+void Mcts::playout(const Board& root_board, std::mt19937_64& rng) {
+    struct Step {
+        Node* node;
+        int actions[2];
+    };
+    thread_local std::vector<Step> path;
+    path.clear();
+
+    Board board = root_board;
+    PlayerColor colors[2] = {root_color_, opponentColor(root_color_)};
+    Node* node = root_.get();
+    int level = 0;
+    double reward = 0;
+
+    while (true) {
+        if (node->terminal) {
+            reward = node->terminal_reward;
+            break;
+        }
+
+        // Visits are counted before the result is known: a virtual loss
+        // that steers other threads elsewhere until backpropagation.
+        node->visits.fetch_add(1, std::memory_order_relaxed);
+        int chosen[2] = {selectAction(*node, 0), selectAction(*node, 1)};
+        node->stats[0][chosen[0]].visits.fetch_add(1, std::memory_order_relaxed);
+        node->stats[1][chosen[1]].visits.fetch_add(1, std::memory_order_relaxed);
+        path.push_back({node, {chosen[0], chosen[1]}});
+
+        int first = level % 2;
+        applyJoint(board, node->actions[first][chosen[first]], colors[first],
+                   node->actions[1 - first][chosen[1 - first]], colors[1 - first]);
+        board.advanceCooldowns(limits_.tick_step);
+        level++;
+
+        uint32_t key = static_cast<uint32_t>(chosen[0]) << 16 | static_cast<uint32_t>(chosen[1]);
+        Node* child;
+        bool created = false;
+        {
+            std::lock_guard<std::mutex> lock(node->mutex);
+            std::unique_ptr<Node>& slot = node->children[key];
+            if (!slot) {
+                slot = makeNode(board);
+                created = true;
+            }
+            child = slot.get();
+        }
+        node = child;
+
+        if (created) {
+            node->visits.fetch_add(1, std::memory_order_relaxed);
+            reward = node->terminal ? node->terminal_reward : rollout(board, level, rng);
+            break;
+        }
+    }
+
+    auto root_reward = static_cast<int64_t>(reward * kRewardScale);
+    for (const Step& step : path) {
+        step.node->stats[0][step.actions[0]].reward.fetch_add(root_reward, std::memory_order_relaxed);
+        step.node->stats[1][step.actions[1]].reward.fetch_add(kRewardScale - root_reward, std::memory_order_relaxed);
+    }
+    playouts_.fetch_add(1, std::memory_order_relaxed);
+}
+
+int Mcts::selectAction(Node& node, int side) const {
+    const ActionStats* stats = node.stats[side].get();
+    size_t count = node.actions[side].size();
+    double log_visits = std::log(static_cast<double>(std::max<uint32_t>(node.visits, 1)));
+
+    int best = 0;
+    double best_score = -1.0;
+    for (size_t i = 0; i < count; i++) {
+        uint32_t visits = stats[i].visits.load(std::memory_order_relaxed);
+        if (visits == 0) {
+            return static_cast<int>(i);
+        }
+        double mean = static_cast<double>(stats[i].reward.load(std::memory_order_relaxed)) / kRewardScale / visits;
+        double score = mean + limits_.exploration * std::sqrt(log_visits / visits);
+        if (score > best_score) {
+            best_score = score;
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+void Mcts::applyJoint(Board& board, const Move& first, PlayerColor first_color,
+                      const Move& second, PlayerColor second_color) const {
+    if (first.piece_id != 0) {
+        board.makeMove(first.piece_id, first.to, cooldownFor(first_color));
+    }
+    if (second.piece_id != 0) {
+        // The first move may have captured or blocked this piece.
+        const Piece* piece = board.findPiece(second.piece_id);
+        if (piece && piece->cooldown_ticks_remaining <= 0 &&
+            validator_.isValidMove(board, second.piece_id, second.to)) {
+            board.makeMove(second.piece_id, second.to, cooldownFor(second_color));
+        }
+    }
+}
+
+double Mcts::rollout(Board& board, int level, std::mt19937_64& rng) const {
+    PlayerColor colors[2] = {root_color_, opponentColor(root_color_)};
+    for (int interval = 0; interval < limits_.rollout_intervals; interval++, level++) {
+        if (auto reward = terminalReward(board)) {
+            return *reward;
+        }
+        std::optional<Move> actions[2] = {rolloutAction(board, colors[0], rng), rolloutAction(board, colors[1], rng)};
+        int first = level % 2;
+        Move wait{0, {0, 0}, {0, 0}, 0};
+        applyJoint(board, actions[first].value_or(wait), colors[first],
+                   actions[1 - first].value_or(wait), colors[1 - first]);
+        board.advanceCooldowns(limits_.tick_step);
+    }
+    if (auto reward = terminalReward(board)) {
+        return *reward;
+    }
+    return evaluate(board);
+}
+
+// Takes a king whenever it can, otherwise mostly the best capture, some
+// random move, or a wait.
+std::optional<Move> Mcts::rolloutAction(const Board& board, PlayerColor color, std::mt19937_64& rng) const {
+    thread_local std::vector<Move> moves;
+    moves.clear();
+    validator_.generateMoves(board, color, moves);
+    if (moves.empty()) {
+        return std::nullopt;
+    }
+
+    const Move* best_capture = nullptr;
+    int best_value = 0;
+    for (const Move& move : moves) {
+        const Piece* victim = board.findPieceAt(move.to);
+        if (victim && kVictimValues[typeIndex(victim->type)] > best_value) {
+            best_value = kVictimValues[typeIndex(victim->type)];
+            best_capture = &move;
+        }
+    }
+    if (best_capture && best_value == kVictimValues[typeIndex(PieceType::KING)]) {
+        return *best_capture;
+    }
+
+    std::uniform_int_distribution<int> percent(0, 99);
+    int roll = percent(rng);
+    if (roll < 25) {
+        return std::nullopt;
+    }
+    if (best_capture && roll < 75) {
+        return *best_capture;
+    }
+    std::uniform_int_distribution<size_t> pick(0, moves.size() - 1);
+    return moves[pick(rng)];
+}
+
+std::optional<double> Mcts::terminalReward(const Board& board) const {
+    bool own_king = board.pieces(root_color_, PieceType::KING) != 0;
+    bool enemy_king = board.pieces(opponentColor(root_color_), PieceType::KING) != 0;
+    if (own_king && enemy_king) {
+        return std::nullopt;
+    }
+    return own_king ? 1.0 : enemy_king ? 0.0 : 0.5;
+}
+
+double Mcts::evaluate(const Board& board) const {
+    return 1.0 / (1.0 + std::exp(-Search::evaluate(board, root_color_) / 400.0));
+}
+
+int Mcts::cooldownFor(PlayerColor color) const {
+    return color == PlayerColor::WHITE ? white_cooldown_ : black_cooldown_;
+}
+
+bool Mcts::shouldStop() const {
+    return playouts_.load(std::memory_order_relaxed) >= limits_.max_playouts ||
+           MctsLimits::Clock::now() >= limits_.deadline ||
+           (limits_.cancel && limits_.cancel->load(std::memory_order_relaxed));
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../core/board.h"
+#include "../core/move_validator.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// Budget and shape of an MCTS decision. One tree level is one interval of
+// `tick_step` ticks in which both sides act at the same time.
+struct MctsLimits {
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t max_playouts = 20000;
+    int threads = 1;
+    int tick_step = 10;
+    int rollout_intervals = 8;
+    double exploration = 0.7;
+    uint64_t seed = 0x6D637473;
+    Clock::time_point deadline = Clock::time_point::max();
+    const std::atomic<bool>* cancel = nullptr;
+};
+
+struct MctsResult {
+    // Empty when waiting scored best.
+    std::optional<Move> best_move;
+    // Mean reward of the chosen action for the root side, 0..1.
+    double value = 0;
+    uint64_t playouts = 0;
+    double playouts_per_second = 0;
+    std::chrono::microseconds elapsed{0};
+};
+
+// Decoupled UCT for simultaneous moves. Each node keeps separate action
+// statistics for both sides; each side picks its action by UCB on its own
+// statistics, and the joint action leads to the child. Both moves of a
+// joint action are applied, the second only if still legal after the
+// first, alternating which side goes first per level.
+//
+// Leaves are scored with a cheap random playout that prefers captures.
+// Threads share one tree: node statistics are atomics, and a visit is
+// counted on the way down (virtual loss) so concurrent threads spread over
+// different actions. Child creation takes the parent's lock.
+class Mcts {
+public:
+    Mcts(PlayerColor root_color, int white_cooldown, int black_cooldown);
+
+    MctsResult run(const Board& board, const MctsLimits& limits);
+
+private:
+    // Scaled to fixed point so rewards can live in integer atomics.
+    static constexpr int64_t kRewardScale = 1 << 16;
+
+    struct ActionStats {
+        std::atomic<uint32_t> visits{0};
+        std::atomic<int64_t> reward{0};
+    };
+
+    struct Node {
+        // Index 0 is always "wait"; indexed by side (0 = root side).
+        std::vector<Move> actions[2];
+        std::unique_ptr<ActionStats[]> stats[2];
+        std::atomic<uint32_t> visits{0};
+        bool terminal = false;
+        double terminal_reward = 0;
+
+        std::mutex mutex;
+        std::unordered_map<uint32_t, std::unique_ptr<Node>> children;
+    };
+
+    std::unique_ptr<Node> makeNode(const Board& board) const;
+    void playout(const Board& root_board, std::mt19937_64& rng);
+    int selectAction(Node& node, int side) const;
+    void applyJoint(Board& board, const Move& first, PlayerColor first_color,
+                    const Move& second, PlayerColor second_color) const;
+    double rollout(Board& board, int level, std::mt19937_64& rng) const;
+    std::optional<Move> rolloutAction(const Board& board, PlayerColor color, std::mt19937_64& rng) const;
+    std::optional<double> terminalReward(const Board& board) const;
+    double evaluate(const Board& board) const;
+    int cooldownFor(PlayerColor color) const;
+    bool shouldStop() const;
+
+    PlayerColor root_color_;
+    int white_cooldown_;
+    int black_cooldown_;
+    MctsLimits limits_;
+    MoveValidator validator_;
+    std::unique_ptr<Node> root_;
+    std::atomic<uint64_t> playouts_;
+};
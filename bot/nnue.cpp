@@ -0,0 +1,411 @@
+#include "nnue.h"
+#include "../core/piece_square_tables.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SPEEDCHESS_X86_64 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(SPEEDCHESS_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define SPEEDCHESS_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define SPEEDCHESS_AVX2_TARGET
+#endif
+
+namespace nnue {
+
+namespace {
+
+const char kMagic[4] = {'S', 'C', 'N', 'N'};
+const uint32_t kFormatVersion = 1;
+
+void addRowScalar(int16_t* values, const int16_t* row) {
+    for (int i = 0; i < kHidden; i++) {
+        values[i] = static_cast<int16_t>(values[i] + row[i]);
+    }
+}
+
+void subRowScalar(int16_t* values, const int16_t* row) {
+    for (int i = 0; i < kHidden; i++) {
+        values[i] = static_cast<int16_t>(values[i] - row[i]);
+    }
+}
+
+int32_t outputScalar(const int16_t* values, const int16_t* weights) {
+    int32_t sum = 0;
+    for (int i = 0; i < kHidden; i++) {
+        int activation = std::clamp<int>(values[i], 0, kActivationMax);
+        sum += activation * weights[i];
+    }
+    return sum;
+}
+
+#ifdef SPEEDCHESS_X86_64
+void addRowSse2(int16_t* values, const int16_t* row) {
+    for (int i = 0; i < kHidden; i += 8) {
+        __m128i sum = _mm_add_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)),
+                                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), sum);
+    }
+}
+
+void subRowSse2(int16_t* values, const int16_t* row) {
+    for (int i = 0; i < kHidden; i += 8) {
+        __m128i difference = _mm_sub_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)),
+                                           _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(values + i), difference);
+    }
+}
+
+int32_t outputSse2(const int16_t* values, const int16_t* weights) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ceiling = _mm_set1_epi16(kActivationMax);
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < kHidden; i += 8) {
+        __m128i activation = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        activation = _mm_min_epi16(_mm_max_epi16(activation, zero), ceiling);
+        __m128i weight = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(activation, weight));
+    }
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+
+SPEEDCHESS_AVX2_TARGET void addRowAvx2(int16_t* values, const int16_t* row) {
+    for (int i = 0; i < kHidden; i += 16) {
+        __m256i sum = _mm256_add_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)),
+                                       _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), sum);
+    }
+}
+
+SPEEDCHESS_AVX2_TARGET void subRowAvx2(int16_t* values, const int16_t* row) {
+    for (int i = 0; i < kHidden; i += 16) {
+        __m256i difference = _mm256_sub_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)),
+                                              _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i), difference);
+    }
+}
+
+SPEEDCHESS_AVX2_TARGET int32_t outputAvx2(const int16_t* values, const int16_t* weights) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ceiling = _mm256_set1_epi16(kActivationMax);
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < kHidden; i += 16) {
+        __m256i activation = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        activation = _mm256_min_epi16(_mm256_max_epi16(activation, zero), ceiling);
+        __m256i weight = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(activation, weight));
+    }
+    __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+    half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(half);
+}
+#endif
+
+bool detectAvx2() {
+#if defined(SPEEDCHESS_X86_64) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#elif defined(SPEEDCHESS_X86_64) && defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+struct SimdState {
+    bool avx2_supported;
+    SimdBackend backend;
+
+    SimdState() {
+        avx2_supported = detectAvx2();
+#ifdef SPEEDCHESS_X86_64
+        backend = avx2_supported ? SimdBackend::AVX2 : SimdBackend::SSE2;
+#else
+        backend = SimdBackend::SCALAR;
+#endif
+    }
+};
+
+SimdState g_simd;
+
+void addRow(int16_t* values, const int16_t* row) {
+    switch (g_simd.backend) {
+#ifdef SPEEDCHESS_X86_64
+        case SimdBackend::AVX2:
+            addRowAvx2(values, row);
+            return;
+        case SimdBackend::SSE2:
+            addRowSse2(values, row);
+            return;
+#endif
+        default:
+            addRowScalar(values, row);
+    }
+}
+
+void subRow(int16_t* values, const int16_t* row) {
+    switch (g_simd.backend) {
+#ifdef SPEEDCHESS_X86_64
+        case SimdBackend::AVX2:
+            subRowAvx2(values, row);
+            return;
+        case SimdBackend::SSE2:
+            subRowSse2(values, row);
+            return;
+#endif
+        default:
+            subRowScalar(values, row);
+    }
+}
+
+int32_t output(const int16_t* values, const int16_t* weights) {
+    switch (g_simd.backend) {
+#ifdef SPEEDCHESS_X86_64
+        case SimdBackend::AVX2:
+            return outputAvx2(values, weights);
+        case SimdBackend::SSE2:
+            return outputSse2(values, weights);
+#endif
+        default:
+            return outputScalar(values, weights);
+    }
+}
+
+template <typename T>
+bool readArray(std::istream& in, std::vector<T>& values) {
+    in.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+    return static_cast<bool>(in);
+}
+
+template <typename T>
+bool readValue(std::istream& in, T& value) {
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    return static_cast<bool>(in);
+}
+
+template <typename T>
+void writeArray(std::ostream& out, const std::vector<T>& values) {
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+template <typename T>
+void writeValue(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+}
+
+bool simdSupported(SimdBackend backend) {
+    switch (backend) {
+        case SimdBackend::SCALAR:
+            return true;
+        case SimdBackend::SSE2:
+#ifdef SPEEDCHESS_X86_64
+            return true;
+#else
+            return false;
+#endif
+        case SimdBackend::AVX2:
+            return g_simd.avx2_supported;
+    }
+    return false;
+}
+
+SimdBackend simdBackend() {
+    return g_simd.backend;
+}
+
+bool setSimdBackend(SimdBackend backend) {
+    if (!simdSupported(backend)) {
+        return false;
+    }
+    g_simd.backend = backend;
+    return true;
+}
+
+Network::Network()
+        : feature_weights(static_cast<size_t>(kInputs) * kHidden, 0),
+          feature_bias(kHidden, 0),
+          output_weights(2 * kHidden, 0) {
+}
+
+bool Network::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    uint32_t inputs = 0;
+    uint32_t hidden = 0;
+    Network loaded;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(magic)) != 0 ||
+        !readValue(in, version) || version != kFormatVersion ||
+        !readValue(in, inputs) || inputs != static_cast<uint32_t>(kInputs) ||
+        !readValue(in, hidden) || hidden != static_cast<uint32_t>(kHidden) ||
+        !readValue(in, loaded.output_scale) || loaded.output_scale <= 0 ||
+        !readArray(in, loaded.feature_weights) ||
+        !readArray(in, loaded.feature_bias) ||
+        !readArray(in, loaded.output_weights) ||
+        !readValue(in, loaded.output_bias)) {
+        return false;
+    }
+
+    *this = std::move(loaded);
+    return true;
+}
+
+bool Network::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        return false;
+    }
+    out.write(kMagic, sizeof(kMagic));
+    writeValue(out, kFormatVersion);
+    writeValue(out, static_cast<uint32_t>(kInputs));
+    writeValue(out, static_cast<uint32_t>(kHidden));
+    writeValue(out, output_scale);
+    writeArray(out, feature_weights);
+    writeArray(out, feature_bias);
+    writeArray(out, output_weights);
+    writeValue(out, output_bias);
+    return static_cast<bool>(out);
+}
+
+int Network::featureIndex(PlayerColor perspective, PlayerColor color, PieceType type, int square, bool cooling) {
+    int relative_color = color == perspective ? 0 : 1;
+    int relative_square = perspective == PlayerColor::WHITE ? square : square ^ 56;
+    return (cooling ? kPieceFeatures : 0) +
+           (relative_color * kPieceTypeCount + typeIndex(type)) * kSquareCount + relative_square;
+}
+
+// Each piece type gets an equal block of hidden units fed only by the
+// perspective's own pieces of that type. Every unit in the block carries the
+// piece-square value divided by a per-type step, with a different rounding
+// offset per unit, so the block as a whole keeps the fractions that a single
+// int16 unit would lose. Steps are large enough that two queens, three rooks
+// or eight advanced pawns stay below the activation ceiling.
+Network Network::fromPieceSquare() {
+    constexpr int kUnitsPerType = kHidden / kPieceTypeCount;
+    constexpr int kSteps[kPieceTypeCount] = {12, 8, 8, 12, 16, 1};
+    constexpr int kCoolingDivisor = 10;
+
+    Network network;
+    network.output_scale = kUnitsPerType;
+    for (int type = 0; type < kPieceTypeCount; type++) {
+        int step = kSteps[type];
+        for (int unit = 0; unit < kUnitsPerType; unit++) {
+            int hidden = type * kUnitsPerType + unit;
+            int offset = unit * step / kUnitsPerType;
+            network.output_weights[hidden] = static_cast<int16_t>(step);
+            network.output_weights[kHidden + hidden] = static_cast<int16_t>(-step);
+
+            for (int square = 0; square < kSquareCount; square++) {
+                PieceType piece_type = static_cast<PieceType>(type);
+                int value = eval::pieceSquare(PlayerColor::WHITE, piece_type, square);
+                int placement = featureIndex(PlayerColor::WHITE, PlayerColor::WHITE, piece_type, square, false);
+                int cooling = featureIndex(PlayerColor::WHITE, PlayerColor::WHITE, piece_type, square, true);
+                network.feature_weights[static_cast<size_t>(placement) * kHidden + hidden] =
+                        static_cast<int16_t>((value + offset) / step);
+                network.feature_weights[static_cast<size_t>(cooling) * kHidden + hidden] =
+                        static_cast<int16_t>(-((value / kCoolingDivisor + offset) / step));
+            }
+        }
+    }
+    return network;
+}
+
+Accumulator::Accumulator()
+        : values_{},
+          pieces_{},
+          cooling_(0),
+          network_(nullptr),
+          feature_updates_(0),
+          resets_(0) {
+}
+
+void Accumulator::apply(const Network& network, PlayerColor color, PieceType type, int square, bool cooling,
+                        bool add) {
+    for (PlayerColor perspective : {PlayerColor::WHITE, PlayerColor::BLACK}) {
+        int feature = Network::featureIndex(perspective, color, type, square, cooling);
+        const int16_t* row = network.feature_weights.data() + static_cast<size_t>(feature) * kHidden;
+        if (add) {
+            addRow(values_[colorIndex(perspective)], row);
+        } else {
+            subRow(values_[colorIndex(perspective)], row);
+        }
+    }
+    feature_updates_++;
+}
+
+void Accumulator::reset(const Network& network, const Board& board) {
+    network_ = &network;
+    resets_++;
+    for (int color = 0; color < kColorCount; color++) {
+        std::copy(network.feature_bias.begin(), network.feature_bias.end(), values_[color]);
+    }
+    std::fill(&pieces_[0][0], &pieces_[0][0] + kColorCount * kPieceTypeCount, Bitboard{0});
+    cooling_ = 0;
+    refresh(network, board);
+}
+
+void Accumulator::refresh(const Network& network, const Board& board) {
+    if (network_ != &network) {
+        reset(network, board);
+        return;
+    }
+
+    Bitboard cooling = board.coolingPieces();
+    for (int color_index = 0; color_index < kColorCount; color_index++) {
+        PlayerColor color = static_cast<PlayerColor>(color_index);
+        for (int type_index = 0; type_index < kPieceTypeCount; type_index++) {
+            PieceType type = static_cast<PieceType>(type_index);
+            Bitboard before = pieces_[color_index][type_index];
+            Bitboard now = board.pieces(color, type);
+            Bitboard cooling_before = before & cooling_;
+            Bitboard cooling_now = now & cooling;
+
+            for (Bitboard removed = before & ~now; removed;) {
+                apply(network, color, type, popLowestSquare(removed), false, false);
+            }
+            for (Bitboard added = now & ~before; added;) {
+                apply(network, color, type, popLowestSquare(added), false, true);
+            }
+            for (Bitboard removed = cooling_before & ~cooling_now; removed;) {
+                apply(network, color, type, popLowestSquare(removed), true, false);
+            }
+            for (Bitboard added = cooling_now & ~cooling_before; added;) {
+                apply(network, color, type, popLowestSquare(added), true, true);
+            }
+            pieces_[color_index][type_index] = now;
+        }
+    }
+    cooling_ = cooling;
+}
+
+int Accumulator::evaluate(const Network& network, PlayerColor side) const {
+    int32_t sum = output(values_[colorIndex(side)], network.output_weights.data()) +
+                  output(values_[colorIndex(opponentColor(side))], network.output_weights.data() + kHidden);
+    return (sum + network.output_bias) / network.output_scale;
+}
+
+int evaluate(const Network& network, const Board& board, PlayerColor side) {
+    Accumulator accumulator;
+    accumulator.reset(network, board);
+    return accumulator.evaluate(network, side);
+}
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../core/board.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Small quantized evaluation network, in the NNUE layout: one int16 hidden
+// layer fed by sparse board features, then a clipped ReLU and a linear
+// output. Inputs are (perspective-relative color, piece type, square) for
+// every piece, plus the same again for every piece still on cooldown. Both
+// sides see the board from their own seat (own pieces first, ranks mirrored
+// for Black) through the same weights, so the hidden layer is kept as two
+// accumulators and the output reads the side to move's one first.
+//
+// The hidden sums are int16 and must not overflow: weights are expected to
+// keep every sum within range for any reachable position.
+namespace nnue {
+
+constexpr int kHidden = 256;
+constexpr int kPieceFeatures = kColorCount * kPieceTypeCount * kSquareCount;
+constexpr int kInputs = 2 * kPieceFeatures;
+constexpr int kActivationMax = 127;
+
+// Accumulator and output kernels. The widest one the CPU supports is picked
+// at startup; all stay callable for testing.
+enum class SimdBackend {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+bool simdSupported(SimdBackend backend);
+SimdBackend simdBackend();
+// Returns false and keeps the current backend if `backend` is not supported.
+bool setSimdBackend(SimdBackend backend);
+
+struct Network {
+    // kInputs rows of kHidden weights.
+    std::vector<int16_t> feature_weights;
+    std::vector<int16_t> feature_bias;
+    // Side to move's half first, then the opponent's.
+    std::vector<int16_t> output_weights;
+    int32_t output_bias = 0;
+    // The output sum divided by this is the score in centipawns.
+    int32_t output_scale = 1;
+
+    // All weights zero.
+    Network();
+
+    // Binary format: "SCNN", format version, input and hidden sizes, output
+    // scale, then the weight arrays in declaration order, native int16/int32.
+    // Returns false, leaving the network untouched, if the file does not
+    // exist or does not match this layout.
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+
+    // A network that reproduces the piece-square evaluation, counting pieces
+    // on cooldown at 90%. A working starting point for training and the
+    // baseline when no trained weights are available.
+    static Network fromPieceSquare();
+
+    static int featureIndex(PlayerColor perspective, PlayerColor color, PieceType type, int square, bool cooling);
+};
+
+// Hidden-layer sums of one network for one board. refresh() brings them up
+// to date by diffing the board's piece and cooldown bitboards against the
+// ones it last saw, so only features that changed since then are applied.
+// In a depth-first search that is the previous leaf, a few features away.
+class Accumulator {
+public:
+    Accumulator();
+
+    void reset(const Network& network, const Board& board);
+    void refresh(const Network& network, const Board& board);
+    // Score in centipawns from `side`'s point of view.
+    int evaluate(const Network& network, PlayerColor side) const;
+
+    uint64_t featureUpdates() const { return feature_updates_; }
+    uint64_t resets() const { return resets_; }
+
+private:
+    void apply(const Network& network, PlayerColor color, PieceType type, int square, bool cooling, bool add);
+
+    alignas(32) int16_t values_[kColorCount][kHidden];
+    Bitboard pieces_[kColorCount][kPieceTypeCount];
+    Bitboard cooling_;
+    const Network* network_;
+    uint64_t feature_updates_;
+    uint64_t resets_;
+};
+
+// One-off evaluation from scratch.
+int evaluate(const Network& network, const Board& board, PlayerColor side);
+
+}
@@ -0,0 +1,607 @@
+#include "search.h"
+#include "../core/sliding_attacks.h"
+#include "../core/zobrist.h"
+#include "../core/piece_square_tables.h"
+#include "../core/static_exchange.h"
+#include <algorithm>
+#include <thread>
+
+Search::Search(PlayerColor root_color, int white_cooldown, int black_cooldown, TranspositionTable* table)
+        : root_color_(root_color),
+          helper_index_(0),
+          white_cooldown_(white_cooldown),
+          black_cooldown_(black_cooldown),
+          cooling_buckets_(1),
+          nodes_(0),
+          stopped_(false),
+          table_(table),
+          state_(nullptr),
+          moved_piece_{},
+          tt_probes_(0),
+          tt_hits_(0),
+          tt_stores_(0) {
+}
+
+SearchResult Search::run(Board& board, const SearchLimits& limits) {
+    auto start = SearchLimits::Clock::now();
+    limits_ = limits;
+    // Two plies per interval; a piece ready only after the last one is as
+    // good as cooling forever.
+    cooling_buckets_ = (std::min(std::max(1, limits.max_depth), kMaxPly) + 1) / 2 + 1;
+    if (limits.horizon_ticks > 0) {
+        cooling_buckets_ = std::min(cooling_buckets_, limits.horizon_ticks / std::max(1, limits.tick_step) + 1);
+    }
+    cooling_buckets_ = std::min(cooling_buckets_, zobrist::kCoolingBuckets);
+    nodes_ = 0;
+    stopped_ = false;
+    tt_probes_ = 0;
+    tt_hits_ = 0;
+    tt_stores_ = 0;
+
+    SearchResult result;
+    // Sized once up front: nodes hold references into their own ply's list.
+    move_stack_.resize(kMaxPly + 1);
+
+    std::vector<Move>& moves = move_stack_[0];
+    moves.clear();
+    validator_.generateMoves(board, root_color_, moves);
+    orderMoves(board, moves);
+
+    // The previous decision's plan first, then the table's; both survive
+    // only if they are still legal here. Each promotion moves to the front,
+    // so the plan is promoted last.
+    uint64_t root_key = positionKey(board, 0, root_color_);
+    TTEntry root_entry;
+    if (probeTable(root_key, 0, root_entry)) {
+        promoteMove(moves, root_entry.piece_id, root_entry.to_square);
+    }
+    if (state_ && !state_->principalVariation().empty()) {
+        const Move& planned = state_->principalVariation().front();
+        promoteMove(moves, planned.piece_id, squareIndex(planned.to));
+    }
+
+    int max_depth = std::min(std::max(1, limits.max_depth), kMaxPly);
+    for (int depth = 1; depth <= max_depth; depth++) {
+        if (skipsDepth(depth)) {
+            continue;
+        }
+        SearchResult iteration;
+        if (!searchRoot(board, depth, iteration)) {
+            if (!result.best_move) {
+                result.best_move = iteration.best_move;
+                result.score = iteration.score;
+            }
+            break;
+        }
+        result.best_move = iteration.best_move;
+        result.score = iteration.score;
+        result.depth = depth;
+
+        if (result.best_move) {
+            int to_square = squareIndex(result.best_move->to);
+            storeTable(root_key, result.score, depth, Bound::EXACT, 0, result.best_move->piece_id, to_square);
+            // Search the previous best move first in the next iteration.
+            promoteMove(moves, result.best_move->piece_id, to_square);
+        }
+    }
+
+    // Out of time before any root move was scored: fall back to ordering.
+    if (!result.best_move && !moves.empty()) {
+        result.best_move = moves.front();
+    }
+
+    result.nodes = nodes_;
+    result.stopped = stopped_;
+    result.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(SearchLimits::Clock::now() - start);
+    result.tt_probes = tt_probes_;
+    result.tt_hits = tt_hits_;
+    result.pv = extractPv(board, result.depth);
+    if (table_) {
+        table_->addStats(tt_probes_, tt_hits_, tt_stores_);
+    }
+    return result;
+}
+
+// Returns false if the budget ran out before every root move was searched.
+bool Search::searchRoot(Board& board, int depth, SearchResult& result) {
+    const std::vector<Move>& moves = move_stack_[0];
+    int alpha = -kInfinity;
+    int beta = kInfinity;
+    PlayerColor enemy = opponentColor(root_color_);
+
+    for (size_t i = 0; i < moves.size(); i++) {
+        Move move = moves[i];
+        moved_piece_[1] = move.piece_id;
+        MoveUndo undo = board.makeMove(move.piece_id, move.to, cooldownFor(root_color_));
+        int score = -searchChild(board, depth - 1, -beta, -alpha, 1, enemy);
+        board.unmakeMove(undo);
+
+        if (stopped_) {
+            return false;
+        }
+        if (score > alpha || !result.best_move) {
+            alpha = std::max(alpha, score);
+            result.best_move = move;
+            result.score = score;
+        }
+    }
+    return true;
+}
+
+int Search::searchChild(Board& board, int depth, int alpha, int beta, int ply, PlayerColor side) {
+    // Both sides have acted once the ply count is even again: advance time.
+    if (ply % 2 == 0) {
+        board.advanceCooldowns(limits_.tick_step);
+        int score = negamax(board, depth, alpha, beta, ply, side);
+        board.advanceCooldowns(-limits_.tick_step);
+        return score;
+    }
+    return negamax(board, depth, alpha, beta, ply, side);
+}
+
+int Search::negamax(Board& board, int depth, int alpha, int beta, int ply, PlayerColor side) {
+    if (shouldStop()) {
+        return 0;
+    }
+    nodes_++;
+
+    if (!board.pieces(side, PieceType::KING)) {
+        return -kMateScore + ply;
+    }
+
+    if (depth <= 0 || beyondHorizon(ply)) {
+        return quiescence(board, alpha, beta, ply, side);
+    }
+
+    uint64_t key = positionKey(board, ply, side);
+    TTEntry entry;
+    bool tt_hit = probeTable(key, ply, entry);
+    if (tt_hit && entry.depth >= depth) {
+        int score = entry.score;
+        if (entry.bound == Bound::EXACT ||
+            (entry.bound == Bound::LOWER && score >= beta) ||
+            (entry.bound == Bound::UPPER && score <= alpha)) {
+            return score;
+        }
+    }
+
+    std::vector<Move>& moves = move_stack_[ply];
+    moves.clear();
+    validator_.generateMoves(board, side, moves);
+    orderMoves(board, moves);
+    if (state_) {
+        const Move& reply = state_->reply(moved_piece_[ply]);
+        promoteMove(moves, reply.piece_id, squareIndex(reply.to));
+    }
+    if (tt_hit) {
+        promoteMove(moves, entry.piece_id, entry.to_square);
+    }
+
+    PlayerColor enemy = opponentColor(side);
+    int original_alpha = alpha;
+    const Move* best_move = nullptr;
+
+    // Waiting is always allowed in racing chess.
+    moved_piece_[ply + 1] = 0;
+    int best = -searchChild(board, depth - 1, -beta, -alpha, ply + 1, enemy);
+    alpha = std::max(alpha, best);
+
+    for (size_t i = 0; i < moves.size() && alpha < beta; i++) {
+        const Move& move = moves[i];
+        moved_piece_[ply + 1] = move.piece_id;
+        MoveUndo undo = board.makeMove(move.piece_id, move.to, cooldownFor(side));
+        int score = -searchChild(board, depth - 1, -beta, -alpha, ply + 1, enemy);
+        board.unmakeMove(undo);
+
+        if (score > best) {
+            best = score;
+            best_move = &move;
+            alpha = std::max(alpha, score);
+        }
+    }
+
+    uint32_t best_piece_id = best_move ? best_move->piece_id : 0;
+    int best_to_square = best_move ? squareIndex(best_move->to) : 0;
+    if (state_ && best_move && best >= beta && !stopped_) {
+        state_->setReply(moved_piece_[ply], *best_move);
+    }
+    Bound bound = best >= beta ? Bound::LOWER : best > original_alpha ? Bound::EXACT : Bound::UPPER;
+    storeTable(key, best, depth, bound, ply, best_piece_id, best_to_square);
+    return best;
+}
+
+int Search::quiescence(Board& board, int alpha, int beta, int ply, PlayerColor side) {
+    if (shouldStop()) {
+        return 0;
+    }
+    nodes_++;
+
+    if (!board.pieces(side, PieceType::KING)) {
+        return -kMateScore + ply;
+    }
+
+    int stand_pat = evaluateLeaf(board, side);
+    if (stand_pat >= beta || ply >= kMaxPly) {
+        return stand_pat;
+    }
+    alpha = std::max(alpha, stand_pat);
+
+    std::vector<Move>& moves = move_stack_[ply];
+    moves.clear();
+    validator_.generateMoves(board, side, moves);
+
+    Bitboard enemies = board.colorOccupancy(opponentColor(side));
+    moves.erase(std::remove_if(moves.begin(), moves.end(), [enemies](const Move& move) {
+        return !(enemies & squareBit(move.to));
+    }), moves.end());
+    // Captures that lose material under static exchange cannot raise the
+    // stand-pat score; drop them.
+    moves.resize(orderMoves(board, moves));
+
+    int best = stand_pat;
+    for (size_t i = 0; i < moves.size(); i++) {
+        Move move = moves[i];
+        MoveUndo undo = board.makeMove(move.piece_id, move.to, cooldownFor(side));
+        int score = -quiescence(board, -beta, -alpha, ply + 1, opponentColor(side));
+        board.unmakeMove(undo);
+
+        if (score > best) {
+            best = score;
+            if (score > alpha) {
+                alpha = score;
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+    }
+
+    return best;
+}
+
+// Captures that win or break even under static exchange come first, best
+// exchange first and most valuable victim / least valuable attacker among
+// equals; then quiet moves; then losing captures. Only the captures are
+// scored, into a scratch buffer reused by every node.
+size_t Search::orderMoves(const Board& board, std::vector<Move>& moves) {
+    Bitboard occupied = board.occupancy();
+    auto captures_end = std::partition(moves.begin(), moves.end(), [occupied](const Move& move) {
+        return (occupied & squareBit(move.to)) != 0;
+    });
+    size_t captures = static_cast<size_t>(captures_end - moves.begin());
+
+    order_keys_.clear();
+    for (size_t i = 0; i < captures; i++) {
+        const Move& move = moves[i];
+        const Piece* victim = board.findPieceAt(move.to);
+        const Piece* attacker = board.findPiece(move.piece_id);
+        int exchange = eval::staticExchange(board, move.piece_id, move.to);
+        int victim_value = victim->type == PieceType::KING ? kMateScore : eval::kPieceValues[typeIndex(victim->type)];
+        int mvv_lva = 10 * victim_value - eval::kPieceValues[typeIndex(attacker->type)] / 10;
+        order_keys_.push_back({static_cast<int64_t>(exchange) * (int64_t{1} << 24) + mvv_lva, move});
+    }
+    std::sort(order_keys_.begin(), order_keys_.end(), [](const OrderKey& a, const OrderKey& b) {
+        return a.key > b.key;
+    });
+
+    size_t winning = 0;
+    while (winning < captures && order_keys_[winning].key >= 0) {
+        winning++;
+    }
+    for (size_t i = 0; i < captures; i++) {
+        moves[i] = order_keys_[i].move;
+    }
+    std::rotate(moves.begin() + winning, moves.begin() + captures, moves.end());
+    return moves.size() - (captures - winning);
+}
+
+int Search::evaluate(const Board& board, PlayerColor side) {
+    return board.psqScore(side) - board.psqScore(opponentColor(side));
+}
+
+int Search::evaluateLeaf(const Board& board, PlayerColor side) {
+    if (!limits_.network) {
+        return evaluate(board, side);
+    }
+    accumulator_.refresh(*limits_.network, board);
+    return accumulator_.evaluate(*limits_.network, side);
+}
+
+void Search::promoteMove(std::vector<Move>& moves, uint32_t piece_id, int to_square) {
+    auto found = std::find_if(moves.begin(), moves.end(), [piece_id, to_square](const Move& move) {
+        return move.piece_id == piece_id && squareIndex(move.to) == to_square;
+    });
+    if (found != moves.end()) {
+        std::rotate(moves.begin(), found, found + 1);
+    }
+}
+
+// Follows stored best actions from the root, replaying the same interval
+// bookkeeping as searchChild, and restores the board afterwards.
+std::vector<Move> Search::extractPv(Board& board, int depth) {
+    std::vector<Move> pv;
+    if (!table_) {
+        return pv;
+    }
+
+    std::vector<MoveUndo> undos;
+    PlayerColor side = root_color_;
+    int ply = 0;
+    for (; ply < depth; ply++) {
+        if (ply > 0 && ply % 2 == 0) {
+            board.advanceCooldowns(limits_.tick_step);
+        }
+        TTEntry entry;
+        bool found = table_->probe(positionKey(board, ply, side), entry);
+        if (found && entry.piece_id != 0) {
+            const Piece* piece = board.findPiece(entry.piece_id);
+            Position to = squarePosition(entry.to_square);
+            found = piece && piece->color == side && piece->cooldown_ticks_remaining <= 0 &&
+                    validator_.isValidMove(board, entry.piece_id, to);
+            if (found) {
+                pv.push_back(Move{entry.piece_id, piece->position, to, 0});
+                undos.push_back(board.makeMove(entry.piece_id, to, cooldownFor(side)));
+            }
+        } else if (found) {
+            pv.push_back(Move{0, {0, 0}, {0, 0}, 0});
+        }
+        if (!found) {
+            if (ply > 0 && ply % 2 == 0) {
+                board.advanceCooldowns(-limits_.tick_step);
+            }
+            break;
+        }
+        side = opponentColor(side);
+    }
+
+    // Unwind in reverse: moves and interval advances interleave.
+    size_t undo_index = undos.size();
+    for (int p = static_cast<int>(pv.size()) - 1; p >= 0; p--) {
+        if (pv[p].piece_id != 0) {
+            board.unmakeMove(undos[--undo_index]);
+        }
+        if (p > 0 && p % 2 == 0) {
+            board.advanceCooldowns(-limits_.tick_step);
+        }
+    }
+    return pv;
+}
+
+// The board hash plus who acts next, where in the cooldown interval the node
+// sits and how many intervals each cooling piece still waits, since all of
+// them change what the same placement is worth.
+uint64_t Search::positionKey(const Board& board, int ply, PlayerColor side) const {
+    uint64_t key = board.hash();
+    if (side == PlayerColor::BLACK) {
+        key ^= zobrist::kKeys.side;
+    }
+    if (ply % 2 != 0) {
+        key ^= zobrist::kKeys.interval;
+    }
+    int step = std::max(1, limits_.tick_step);
+    for (Bitboard cooling = board.coolingPieces(); cooling;) {
+        int square = popLowestSquare(cooling);
+        int ticks = board.findPiece(board.pieceIdAt(square))->cooldown_ticks_remaining;
+        int bucket = std::min((ticks + step - 1) / step, cooling_buckets_);
+        key ^= zobrist::kKeys.cooling_interval[bucket - 1][square];
+    }
+    return key;
+}
+
+// Mate scores are stored relative to the node so they stay correct when the
+// position is reached at a different ply.
+bool Search::probeTable(uint64_t key, int ply, TTEntry& entry) {
+    if (!table_) {
+        return false;
+    }
+    tt_probes_++;
+    if (!table_->probe(key, entry)) {
+        return false;
+    }
+    tt_hits_++;
+    if (entry.score > kMateScore - 2 * kMaxPly) {
+        entry.score -= ply;
+    } else if (entry.score < -kMateScore + 2 * kMaxPly) {
+        entry.score += ply;
+    }
+    return true;
+}
+
+void Search::storeTable(uint64_t key, int score, int depth, Bound bound, int ply, uint32_t piece_id, int to_square) {
+    if (!table_ || stopped_) {
+        return;
+    }
+    if (score > kMateScore - 2 * kMaxPly) {
+        score += ply;
+    } else if (score < -kMateScore + 2 * kMaxPly) {
+        score -= ply;
+    }
+    TTEntry entry;
+    entry.score = score;
+    entry.depth = depth;
+    entry.bound = bound;
+    entry.piece_id = piece_id;
+    entry.to_square = to_square;
+    table_->store(key, entry);
+    tt_stores_++;
+}
+
+// Skip-block pattern for helpers: helper i alternates runs of kSkipSize[i]
+// searched and skipped depths, offset by kSkipPhase[i].
+bool Search::skipsDepth(int depth) const {
+    static const int kSkipSize[] = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+    static const int kSkipPhase[] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+    if (helper_index_ == 0 || depth == 1) {
+        return false;
+    }
+    int index = (helper_index_ - 1) % 20;
+    return ((depth + kSkipPhase[index]) / kSkipSize[index]) % 2 != 0;
+}
+
+// The clock and the cancel flag are only read every 1024 nodes; once set, the flag unwinds the
+// whole tree and the unfinished iteration is discarded.
+bool Search::shouldStop() {
+    if (stopped_) {
+        return true;
+    }
+    if (limits_.max_nodes > 0 && nodes_ >= limits_.max_nodes) {
+        stopped_ = true;
+    } else if ((nodes_ & 1023) == 0) {
+        stopped_ = SearchLimits::Clock::now() >= limits_.deadline ||
+                   (limits_.cancel && limits_.cancel->load(std::memory_order_relaxed));
+    }
+    return stopped_;
+}
+
+int Search::cooldownFor(PlayerColor color) const {
+    return color == PlayerColor::WHITE ? white_cooldown_ : black_cooldown_;
+}
+
+bool Search::beyondHorizon(int ply) const {
+    return limits_.horizon_ticks > 0 && (ply / 2) * limits_.tick_step > limits_.horizon_ticks;
+}
+
+SearchResult searchParallel(Board& board, PlayerColor root_color, int white_cooldown, int black_cooldown,
+                            const SearchLimits& limits, TranspositionTable* table, int threads,
+                            SearchState* state) {
+    Search main_search(root_color, white_cooldown, black_cooldown, table);
+    main_search.setState(state);
+    if (threads <= 1) {
+        return main_search.run(board, limits);
+    }
+
+    // Helpers have no node budget of their own; they stop with the main
+    // search, which also forwards any external cancel through its result.
+    std::atomic<bool> stop_helpers(false);
+    SearchLimits helper_limits = limits;
+    helper_limits.max_nodes = 0;
+    helper_limits.cancel = &stop_helpers;
+
+    // Copied up front: the main search mutates `board` while helpers run.
+    std::vector<Board> helper_boards(threads - 1, board);
+    std::vector<SearchResult> helper_results(threads - 1);
+
+    // The guard stops and joins the helpers however the block is left, so
+    // a throwing main search or thread start never destroys a joinable thread.
+    struct JoinHelpers {
+        std::atomic<bool>& stop;
+        std::vector<std::thread> pool;
+        ~JoinHelpers() {
+            stop = true;
+            for (auto& thread : pool) {
+                thread.join();
+            }
+        }
+    };
+
+    SearchResult result;
+    {
+        JoinHelpers helpers{stop_helpers, {}};
+        helpers.pool.reserve(threads - 1);
+        for (int i = 1; i < threads; i++) {
+            helpers.pool.emplace_back([&, i] {
+                Search helper(root_color, white_cooldown, black_cooldown, table);
+                helper.setHelperIndex(i);
+                helper_results[i - 1] = helper.run(helper_boards[i - 1], helper_limits);
+            });
+        }
+        result = main_search.run(board, limits);
+    }
+
+    for (const auto& helper_result : helper_results) {
+        result.nodes += helper_result.nodes;
+        result.tt_probes += helper_result.tt_probes;
+        result.tt_hits += helper_result.tt_hits;
+    }
+    return result;
+}
+
+SearchState::SearchState()
+        : replies_{},
+          changed_(0) {
+}
+
+Bitboard SearchState::update(const Board& root) {
+    if (!root_) {
+        changed_ = ~Bitboard(0);
+    } else {
+        changed_ = 0;
+        for (int color = 0; color < kColorCount; color++) {
+            for (int type = 0; type < kPieceTypeCount; type++) {
+                PlayerColor player = static_cast<PlayerColor>(color);
+                PieceType piece_type = static_cast<PieceType>(type);
+                changed_ |= root_->pieces(player, piece_type) ^ root.pieces(player, piece_type);
+            }
+        }
+    }
+    root_ = root;
+
+    // Our planned move was played if its piece now stands on its target.
+    // Then the opponent's slot has passed as well: its predicted step goes
+    // either way, and only explains its squares if it is what happened.
+    Bitboard unexplained = changed_;
+    size_t played = 0;
+    if (!pv_.empty() && isPlayed(root, pv_[0])) {
+        unexplained &= ~ends(pv_[0]);
+        played = 1;
+        if (pv_.size() > 1) {
+            if (isPlayed(root, pv_[1])) {
+                unexplained &= ~ends(pv_[1]);
+            }
+            played = 2;
+        }
+    }
+    pv_.erase(pv_.begin(), pv_.begin() + played);
+
+    // The rest is kept up to the first step that crosses a square that
+    // changed for any other reason.
+    auto broken = std::find_if(pv_.begin(), pv_.end(), [unexplained](const Move& move) {
+        return move.piece_id != 0 && (footprint(move) & unexplained);
+    });
+    pv_.erase(broken, pv_.end());
+
+    for (Move& reply : replies_) {
+        if (reply.piece_id != 0 && (footprint(reply) & changed_)) {
+            reply = Move{};
+        }
+    }
+    return changed_;
+}
+
+void SearchState::record(const SearchResult& result) {
+    pv_ = result.pv;
+}
+
+void SearchState::clear() {
+    root_.reset();
+    pv_.clear();
+    replies_.fill(Move{});
+    changed_ = 0;
+}
+
+// A wait leaves no trace, so it counts as played.
+bool SearchState::isPlayed(const Board& root, const Move& move) {
+    if (move.piece_id == 0) {
+        return true;
+    }
+    const Piece* piece = root.findPiece(move.piece_id);
+    return piece && !piece->captured && piece->position == move.to;
+}
+
+Bitboard SearchState::ends(const Move& move) {
+    return move.piece_id == 0 ? 0 : squareBit(move.from) | squareBit(move.to);
+}
+
+// Origin, target and every square a slider passes over on the way.
+Bitboard SearchState::footprint(const Move& move) {
+    int from = squareIndex(move.from);
+    int to = squareIndex(move.to);
+    Bitboard ends = squareBit(from) | squareBit(to);
+    if (attacks::rookAttacks(from, 0) & squareBit(to)) {
+        return ends | (attacks::rookAttacks(from, squareBit(to)) & attacks::rookAttacks(to, squareBit(from)));
+    }
+    if (attacks::bishopAttacks(from, 0) & squareBit(to)) {
+        return ends | (attacks::bishopAttacks(from, squareBit(to)) & attacks::bishopAttacks(to, squareBit(from)));
+    }
+    return ends;
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "../core/board.h"
+#include "../core/move_validator.h"
+#include "nnue.h"
+#include "transposition_table.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Racing-chess time model: the searching side and its opponent both get one
+// action (a move, or waiting) per interval of `tick_step` simulated ticks.
+// Between intervals every cooldown runs down by `tick_step`, so pieces come
+// back into play exactly when they would in the real game.
+//
+// The search deepens iteratively up to `max_depth` and stops early once the
+// deadline passes, `max_nodes` (0 = unlimited) have been visited, or another
+// thread sets `*cancel`.
+//
+// Leaves are scored with the piece-square evaluation unless `network` is
+// set; the network must outlive the search.
+struct SearchLimits {
+    using Clock = std::chrono::steady_clock;
+
+    int max_depth = 4;
+    int tick_step = 10;
+    int horizon_ticks = 0;
+    uint64_t max_nodes = 0;
+    Clock::time_point deadline = Clock::time_point::max();
+    const std::atomic<bool>* cancel = nullptr;
+    const nnue::Network* network = nullptr;
+};
+
+// `depth` is the last iteration that finished; `best_move` comes from it
+// unless not even depth 1 completed, in which case it is the best root move
+// seen before the budget ran out.
+struct SearchResult {
+    std::optional<Move> best_move;
+    int score = 0;
+    int depth = 0;
+    uint64_t nodes = 0;
+    bool stopped = false;
+    std::chrono::microseconds elapsed{0};
+    uint64_t tt_probes = 0;
+    uint64_t tt_hits = 0;
+    // Principal variation read back from the table; piece id 0 is a wait.
+    std::vector<Move> pv;
+};
+
+// Search knowledge carried from one decision to the next: the previous
+// principal variation and, per moving piece, the reply that refuted it.
+// update() diffs the new root against the previous one, drops the plan's
+// steps the new root shows as played (our move, then the opponent's turn)
+// and anything else whose squares changed; the rest keeps guiding move
+// ordering, with our next planned move first. Subtrees
+// untouched by the change are still in the transposition table under the
+// same keys, so only the affected ones get searched from scratch.
+class SearchState {
+public:
+    SearchState();
+
+    // Returns the squares whose contents differ from the previous root.
+    Bitboard update(const Board& root);
+    void record(const SearchResult& result);
+    void clear();
+
+    const std::vector<Move>& principalVariation() const { return pv_; }
+    Bitboard changedSquares() const { return changed_; }
+
+    const Move& reply(uint32_t piece_id) const { return replies_[piece_id]; }
+    void setReply(uint32_t piece_id, const Move& reply) { replies_[piece_id] = reply; }
+
+private:
+    static Bitboard footprint(const Move& move);
+    static bool isPlayed(const Board& root, const Move& move);
+    static Bitboard ends(const Move& move);
+
+    std::optional<Board> root_;
+    std::vector<Move> pv_;
+    // Indexed by the id of the piece that just moved; piece id 0 = none.
+    std::array<Move, Board::kMaxPieces + 1> replies_;
+    Bitboard changed_;
+};
+
+class Search {
+public:
+    static constexpr int kMateScore = 100000;
+    static constexpr int kInfinity = 1000000;
+    static constexpr int kMaxPly = 128;
+
+    // `table` is optional and may be shared with other searches.
+    Search(PlayerColor root_color, int white_cooldown, int black_cooldown,
+           TranspositionTable* table = nullptr);
+
+    // Searches `board` in place through make/unmake; the board is restored
+    // before returning.
+    SearchResult run(Board& board, const SearchLimits& limits);
+
+    static int evaluate(const Board& board, PlayerColor side);
+
+    // Non-zero for Lazy SMP helper threads, which skip some iterations so
+    // threads sharing a table spread over different depths.
+    void setHelperIndex(int index) { helper_index_ = index; }
+    // Optional state to seed ordering from and record replies into. Not
+    // thread-safe: only give it to one search at a time.
+    void setState(SearchState* state) { state_ = state; }
+
+private:
+    int negamax(Board& board, int depth, int alpha, int beta, int ply, PlayerColor side);
+    int quiescence(Board& board, int alpha, int beta, int ply, PlayerColor side);
+    int evaluateLeaf(const Board& board, PlayerColor side);
+    int searchChild(Board& board, int depth, int alpha, int beta, int ply, PlayerColor side);
+    bool searchRoot(Board& board, int depth, SearchResult& result);
+    bool shouldStop();
+    bool skipsDepth(int depth) const;
+
+    // Returns the number of moves ahead of the losing captures.
+    size_t orderMoves(const Board& board, std::vector<Move>& moves);
+    static void promoteMove(std::vector<Move>& moves, uint32_t piece_id, int to_square);
+    std::vector<Move> extractPv(Board& board, int depth);
+    uint64_t positionKey(const Board& board, int ply, PlayerColor side) const;
+    bool probeTable(uint64_t key, int ply, TTEntry& entry);
+    void storeTable(uint64_t key, int score, int depth, Bound bound, int ply, uint32_t piece_id, int to_square);
+    int cooldownFor(PlayerColor color) const;
+    bool beyondHorizon(int ply) const;
+
+    PlayerColor root_color_;
+    int helper_index_;
+    int white_cooldown_;
+    int black_cooldown_;
+    SearchLimits limits_;
+    // Intervals a cooldown can still matter within this search's horizon.
+    int cooling_buckets_;
+    uint64_t nodes_;
+    bool stopped_;
+    MoveValidator validator_;
+    TranspositionTable* table_;
+    SearchState* state_;
+    // Piece moved to reach each ply; 0 when the side waited.
+    std::array<uint32_t, kMaxPly + 1> moved_piece_;
+    uint64_t tt_probes_;
+    uint64_t tt_hits_;
+    uint64_t tt_stores_;
+    std::vector<std::vector<Move>> move_stack_;
+
+    struct OrderKey {
+        int64_t key;
+        Move move;
+    };
+    std::vector<OrderKey> order_keys_;
+    nnue::Accumulator accumulator_;
+};
+
+// Lazy SMP: `threads` searches of the same root share `table` and differ only
+// in which depths they visit. The calling thread runs the main search; its
+// result is returned once it finishes and the helpers are stopped. Node
+// counts cover all threads. Only the main search sees `state`.
+SearchResult searchParallel(Board& board, PlayerColor root_color, int white_cooldown, int black_cooldown,
+                            const SearchLimits& limits, TranspositionTable* table, int threads,
+                            SearchState* state = nullptr);
@@ -0,0 +1,350 @@
+#include "tournament.h"
+#include "../utility/clock_source.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace {
+
+bool parseInt(const std::string& text, int& value) {
+    if (text.empty()) {
+        return false;
+    }
+    char* end = nullptr;
+    long parsed = std::strtol(text.c_str(), &end, 10);
+    if (*end != '\0' || parsed < 0 || parsed > std::numeric_limits<int>::max()) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+bool parseDifficulty(const std::string& text, AIDifficulty& difficulty) {
+    if (text == "easy") {
+        difficulty = AIDifficulty::EASY;
+    } else if (text == "medium") {
+        difficulty = AIDifficulty::MEDIUM;
+    } else if (text == "hard") {
+        difficulty = AIDifficulty::HARD;
+    } else if (text == "expert") {
+        difficulty = AIDifficulty::EXPERT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parseEngine(const std::string& text, std::optional<AIEngine>& engine) {
+    if (text == "default") {
+        engine.reset();
+    } else if (text == "heuristic") {
+        engine = AIEngine::HEURISTIC;
+    } else if (text == "alpha-beta") {
+        engine = AIEngine::ALPHA_BETA;
+    } else if (text == "mcts") {
+        engine = AIEngine::MCTS;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool hasReadyPiece(const Board& board, PlayerColor side) {
+    return (board.colorOccupancy(side) & ~board.coolingPieces()) != 0;
+}
+
+}
+
+bool parsePlayerConfig(const std::string& spec, PlayerConfig& config) {
+    std::stringstream stream(spec);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (item.empty()) {
+            continue;
+        }
+        size_t separator = item.find('=');
+        if (separator == std::string::npos) {
+            return false;
+        }
+        std::string key = item.substr(0, separator);
+        std::string value = item.substr(separator + 1);
+        int number = 0;
+
+        if (key == "name") {
+            config.name = value;
+        } else if (key == "difficulty") {
+            if (!parseDifficulty(value, config.difficulty)) {
+                return false;
+            }
+        } else if (key == "engine") {
+            if (!parseEngine(value, config.engine)) {
+                return false;
+            }
+        } else if (key == "threads") {
+            if (!parseInt(value, number) || number < 1) {
+                return false;
+            }
+            config.threads = number;
+        } else if (key == "hash") {
+            if (!parseInt(value, number) || number < 1) {
+                return false;
+            }
+            config.hash_megabytes = static_cast<size_t>(number);
+        } else if (key == "movetime") {
+            if (!parseInt(value, number)) {
+                return false;
+            }
+            config.move_time = std::chrono::milliseconds(number);
+        } else if (key == "reaction") {
+            if (!parseInt(value, number)) {
+                return false;
+            }
+            config.reaction_ticks = number;
+        } else if (key == "network") {
+            auto network = std::make_shared<nnue::Network>();
+            if (!network->load(value)) {
+                return false;
+            }
+            config.network = std::move(network);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+GameRecord playGame(const GameOptions& options, const PlayerConfig& white, const PlayerConfig& black) {
+    using Clock = std::chrono::steady_clock;
+    auto game_start = Clock::now();
+
+    GameRecord record;
+    auto manual_clock = std::make_unique<ManualClock>();
+    ManualClock* clock = manual_clock.get();
+    Game game(nullptr, std::move(manual_clock));
+    GameSettings settings{};
+    settings.white_cooldown_ticks = options.white_cooldown;
+    settings.black_cooldown_ticks = options.black_cooldown;
+    settings.tick_rate_ms = 100;
+    settings.against_ai = true;
+    settings.fen_string = options.fen;
+    game.applySettings(settings);
+    game.start();
+
+    const PlayerConfig* configs[kColorCount] = {&white, &black};
+    std::vector<AIPlayer> players;
+    players.reserve(kColorCount);
+    for (int color = 0; color < kColorCount; color++) {
+        const PlayerConfig& config = *configs[color];
+        players.emplace_back(config.difficulty, static_cast<PlayerColor>(color), config.engine);
+        players.back().setThreads(config.threads);
+        players.back().setHashSize(config.hash_megabytes);
+        players.back().setNetwork(config.network);
+    }
+
+    int next_action[kColorCount] = {0, 0};
+    for (int tick = 0; tick < options.max_ticks; tick++) {
+        record.ticks = tick + 1;
+        for (int turn = 0; turn < kColorCount; turn++) {
+            PlayerColor side = static_cast<PlayerColor>((tick + turn) % kColorCount);
+            int index = colorIndex(side);
+            if (tick < next_action[index]) {
+                continue;
+            }
+            // Only this loop moves and the clock stands still meanwhile, so
+            // the copy stays current until our own move.
+            Board board = game.getBoard();
+            if (!hasReadyPiece(board, side)) {
+                continue;
+            }
+
+            const PlayerConfig& config = *configs[index];
+            AIPlayer& player = players[index];
+            auto deadline = config.move_time.count() > 0 ? Clock::now() + config.move_time
+                                                         : Clock::time_point::max();
+            auto think_start = Clock::now();
+            std::optional<Move> move = player.getBestMove(game, deadline);
+            auto think_time = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - think_start);
+
+            const Piece* piece = move ? board.findPiece(move->piece_id) : nullptr;
+            Position from = piece ? piece->position : Position{0, 0};
+            if (!piece || piece->color != side || !game.makeMove(move->piece_id, move->to)) {
+                next_action[index] = tick + 1;
+                continue;
+            }
+
+            MoveRecord move_record;
+            move_record.tick = tick;
+            move_record.side = side;
+            move_record.move = *move;
+            move_record.move.from = from;
+            move_record.think_time = think_time;
+            if (player.getEngine() == AIEngine::ALPHA_BETA) {
+                move_record.nodes = player.getLastSearch().nodes;
+                move_record.depth = player.getLastSearch().depth;
+            } else if (player.getEngine() == AIEngine::MCTS) {
+                move_record.nodes = player.getLastMcts().playouts;
+            }
+            record.moves.push_back(move_record);
+            next_action[index] = tick + std::max(1, config.reaction_ticks);
+
+            if (game.getState() != GameState::ACTIVE) {
+                record.result = game.getState() == GameState::WHITE_WIN ? GameResult::WHITE_WIN : GameResult::BLACK_WIN;
+                record.wall_time = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - game_start);
+                return record;
+            }
+        }
+        clock->advance();
+    }
+
+    record.result = GameResult::DRAW;
+    record.wall_time = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - game_start);
+    return record;
+}
+
+double MatchScore::score() const {
+    return games() == 0 ? 0.5 : (wins + 0.5 * draws) / games();
+}
+
+void MatchScore::add(GameResult result, bool first_is_white) {
+    if (result == GameResult::DRAW) {
+        draws++;
+    } else if ((result == GameResult::WHITE_WIN) == first_is_white) {
+        wins++;
+    } else {
+        losses++;
+    }
+}
+
+double eloFromScore(double score) {
+    if (score <= 0.0) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    if (score >= 1.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+    return -400.0 * std::log10(1.0 / score - 1.0);
+}
+
+double scoreFromElo(double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+namespace {
+
+// Per-game variance of the score (1, 0.5 or 0).
+double scoreVariance(const MatchScore& score) {
+    int games = score.games();
+    if (games == 0) {
+        return 0.0;
+    }
+    double mean = score.score();
+    double mean_square = (score.wins + 0.25 * score.draws) / games;
+    return std::max(0.0, mean_square - mean * mean);
+}
+
+}
+
+EloEstimate estimateElo(const MatchScore& score) {
+    EloEstimate estimate;
+    double mean = score.score();
+    estimate.elo = eloFromScore(mean);
+    estimate.lower = estimate.elo;
+    estimate.upper = estimate.elo;
+    if (score.games() == 0) {
+        return estimate;
+    }
+
+    const double z95 = 1.959964;
+    double margin = z95 * std::sqrt(scoreVariance(score) / score.games());
+    estimate.lower = eloFromScore(mean - margin);
+    estimate.upper = eloFromScore(mean + margin);
+    return estimate;
+}
+
+SprtResult sprt(const MatchScore& score, double elo0, double elo1, double alpha, double beta) {
+    SprtResult result;
+    result.lower_bound = std::log(beta / (1.0 - alpha));
+    result.upper_bound = std::log((1.0 - beta) / alpha);
+
+    double variance = scoreVariance(score);
+    if (score.games() == 0 || variance <= 0.0) {
+        return result;
+    }
+
+    double s0 = scoreFromElo(elo0);
+    double s1 = scoreFromElo(elo1);
+    result.llr = score.games() * (s1 - s0) * (2.0 * score.score() - s0 - s1) / (2.0 * variance);
+    if (result.llr >= result.upper_bound) {
+        result.decision = SprtDecision::ACCEPT_H1;
+    } else if (result.llr <= result.lower_bound) {
+        result.decision = SprtDecision::ACCEPT_H0;
+    }
+    return result;
+}
+
+std::vector<GameRecord> runTournament(const TournamentOptions& options, const PlayerConfig& first,
+                                      const PlayerConfig& second,
+                                      const std::function<void(const GameRecord&, const MatchScore&)>& on_game) {
+    std::vector<std::optional<GameRecord>> slots(static_cast<size_t>(std::max(0, options.games)));
+    std::atomic<int> next_game(0);
+    std::atomic<bool> stop(false);
+    std::mutex mutex;
+    MatchScore score;
+
+    auto worker = [&]() {
+        while (!stop) {
+            int index = next_game++;
+            if (index >= options.games) {
+                return;
+            }
+
+            GameOptions game;
+            int opening_index = static_cast<int>((index / 2) % std::max<size_t>(1, options.openings.size()));
+            game.fen = options.openings.empty() ? "standard" : options.openings[opening_index];
+            game.white_cooldown = options.white_cooldown;
+            game.black_cooldown = options.black_cooldown;
+            game.max_ticks = options.max_ticks;
+            bool first_is_white = index % 2 == 0;
+
+            GameRecord record = first_is_white ? playGame(game, first, second) : playGame(game, second, first);
+            record.game_index = index;
+            record.opening_index = opening_index;
+            record.first_is_white = first_is_white;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            score.add(record.result, first_is_white);
+            if (on_game) {
+                on_game(record, score);
+            }
+            slots[index] = std::move(record);
+            if (options.stop_on_sprt &&
+                sprt(score, options.elo0, options.elo1, options.alpha, options.beta).decision != SprtDecision::CONTINUE) {
+                stop = true;
+            }
+        }
+    };
+
+    int threads = std::max(1, std::min(options.concurrency, options.games));
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (int i = 1; i < threads; i++) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    std::vector<GameRecord> records;
+    for (auto& slot : slots) {
+        if (slot) {
+            records.push_back(std::move(*slot));
+        }
+    }
+    return records;
+}
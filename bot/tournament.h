@@ -0,0 +1,144 @@
+#pragma once
+
+#include "ai_player.h"
+#include "nnue.h"
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Headless AI-vs-AI play on a simulated clock, for tuning difficulty levels
+// and catching strength or speed regressions. Each game is a Game driven by
+// a ManualClock, with no UI: it advances one tick at a time, as fast as the
+// players decide.
+
+// One side's AIPlayer setup. Without a move time the player searches to its
+// difficulty's depth/node/playout budget, so results do not depend on how
+// loaded the machine is.
+struct PlayerConfig {
+    std::string name = "player";
+    AIDifficulty difficulty = AIDifficulty::MEDIUM;
+    std::optional<AIEngine> engine;
+    int threads = 1;
+    size_t hash_megabytes = 4;
+    std::chrono::milliseconds move_time{0};
+    // Simulated ticks the player waits after moving before it acts again,
+    // like the UI's move delay.
+    int reaction_ticks = 1;
+    std::shared_ptr<const nnue::Network> network;
+};
+
+// Parses a comma-separated spec such as
+// "name=new,difficulty=hard,engine=mcts,threads=2,hash=8,movetime=50,reaction=2,network=net.nnue"
+// on top of `config`. Returns false on an unknown key or bad value, or if
+// the network file does not load.
+bool parsePlayerConfig(const std::string& spec, PlayerConfig& config);
+
+enum class GameResult {
+    WHITE_WIN,
+    BLACK_WIN,
+    DRAW
+};
+
+struct MoveRecord {
+    int tick = 0;
+    PlayerColor side = PlayerColor::WHITE;
+    Move move{};
+    std::chrono::microseconds think_time{0};
+    // Search nodes or MCTS playouts; 0 for the heuristic engine.
+    uint64_t nodes = 0;
+    int depth = 0;
+};
+
+struct GameOptions {
+    std::string fen = "standard";
+    int white_cooldown = 10;
+    int black_cooldown = 10;
+    // Unfinished games are drawn after this many ticks.
+    int max_ticks = 3000;
+};
+
+struct GameRecord {
+    int game_index = 0;
+    int opening_index = 0;
+    // True when the tournament's first player had White.
+    bool first_is_white = true;
+    GameResult result = GameResult::DRAW;
+    int ticks = 0;
+    std::chrono::microseconds wall_time{0};
+    std::vector<MoveRecord> moves;
+};
+
+// Plays until a king is captured or `max_ticks` pass. On every tick each
+// side whose reaction delay has passed and that has a ready piece asks its
+// player for a move; the sides take turns going first. Then the clock
+// advances one tick.
+GameRecord playGame(const GameOptions& options, const PlayerConfig& white, const PlayerConfig& black);
+
+// Results from the first player's point of view.
+struct MatchScore {
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+
+    int games() const { return wins + draws + losses; }
+    // Wins plus half the draws, as a fraction of games played.
+    double score() const;
+    void add(GameResult result, bool first_is_white);
+};
+
+// Logistic Elo model.
+double eloFromScore(double score);
+double scoreFromElo(double elo);
+
+// Elo difference with a 95% confidence interval from the per-game score
+// variance. When every game had the same result the interval collapses onto
+// the estimate, which is infinite for a clean sweep.
+struct EloEstimate {
+    double elo = 0;
+    double lower = 0;
+    double upper = 0;
+};
+EloEstimate estimateElo(const MatchScore& score);
+
+enum class SprtDecision {
+    CONTINUE,
+    ACCEPT_H0,
+    ACCEPT_H1
+};
+
+// Sequential probability ratio test of H0 "elo = elo0" against H1
+// "elo = elo1", using the normal approximation of the trinomial
+// log-likelihood ratio. Stays undecided while every game has had the same
+// result, since the approximation needs some variance.
+struct SprtResult {
+    double llr = 0;
+    double lower_bound = 0;
+    double upper_bound = 0;
+    SprtDecision decision = SprtDecision::CONTINUE;
+};
+SprtResult sprt(const MatchScore& score, double elo0, double elo1, double alpha, double beta);
+
+struct TournamentOptions {
+    int games = 100;
+    int concurrency = 1;
+    // Each opening is played twice in a row with colors swapped.
+    std::vector<std::string> openings = {"standard"};
+    int white_cooldown = 10;
+    int black_cooldown = 10;
+    int max_ticks = 3000;
+    double elo0 = 0;
+    double elo1 = 10;
+    double alpha = 0.05;
+    double beta = 0.05;
+    // Skips the remaining games once the SPRT reaches a decision.
+    bool stop_on_sprt = false;
+};
+
+// Runs the games on `concurrency` threads. `on_game` is called for every
+// finished game, one call at a time, with the running score. Returns the
+// records in game order; skipped games are left out.
+std::vector<GameRecord> runTournament(const TournamentOptions& options, const PlayerConfig& first,
+                                      const PlayerConfig& second,
+                                      const std::function<void(const GameRecord&, const MatchScore&)>& on_game = nullptr);
@@ -0,0 +1,165 @@
+#include "transposition_table.h"
+#include <algorithm>
+
+namespace {
+
+// data layout: piece id (8) | target square (6) | bound (2) | generation (6)
+// | depth (8) | unused (2) | score (32). Piece id 0 means "wait".
+constexpr int kGenerationBits = 6;
+constexpr uint8_t kGenerationMask = (1 << kGenerationBits) - 1;
+
+uint64_t pack(const TTEntry& entry, uint8_t generation) {
+    uint64_t data = 0;
+    data |= entry.piece_id & 0xFF;
+    data |= static_cast<uint64_t>(entry.to_square & 0x3F) << 8;
+    data |= static_cast<uint64_t>(entry.bound) << 14;
+    data |= static_cast<uint64_t>(generation & kGenerationMask) << 16;
+    data |= static_cast<uint64_t>(std::clamp(entry.depth, 0, 255)) << 22;
+    data |= static_cast<uint64_t>(static_cast<uint32_t>(entry.score)) << 32;
+    return data;
+}
+
+TTEntry unpack(uint64_t data) {
+    TTEntry entry;
+    entry.piece_id = data & 0xFF;
+    entry.to_square = (data >> 8) & 0x3F;
+    entry.bound = static_cast<Bound>((data >> 14) & 0x3);
+    entry.depth = static_cast<int>((data >> 22) & 0xFF);
+    entry.score = static_cast<int32_t>(data >> 32);
+    return entry;
+}
+
+uint8_t generationOf(uint64_t data) {
+    return (data >> 16) & kGenerationMask;
+}
+
+int depthOf(uint64_t data) {
+    return static_cast<int>((data >> 22) & 0xFF);
+}
+
+Bound boundOf(uint64_t data) {
+    return static_cast<Bound>((data >> 14) & 0x3);
+}
+
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+        : generation_(0),
+          probes_(0),
+          hits_(0),
+          stores_(0) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    size_t bytes = std::max<size_t>(megabytes, 1) << 20;
+    // Power-of-two cluster count so the index is a mask of the key.
+    size_t count = 1;
+    while (count * 2 * sizeof(Cluster) <= bytes) {
+        count *= 2;
+    }
+
+    // Value-initialised, so the fresh table starts zeroed (all slots empty).
+    clusters_ = std::vector<Cluster>(count);
+    generation_.store(0, std::memory_order_relaxed);
+    resetStats();
+}
+
+void TranspositionTable::clear() {
+    for (Cluster& cluster : clusters_) {
+        for (Slot& slot : cluster.slots) {
+            slot.check.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation_.store(0, std::memory_order_relaxed);
+    resetStats();
+}
+
+void TranspositionTable::newSearch() {
+    generation_.store((generation_.load(std::memory_order_relaxed) + 1) & kGenerationMask,
+                      std::memory_order_relaxed);
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    const Cluster& cluster = clusterFor(key);
+    for (const Slot& slot : cluster.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key && boundOf(data) != Bound::NONE) {
+            entry = unpack(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, const TTEntry& entry) {
+    Cluster& cluster = clusterFor(key);
+    uint8_t generation = generation_.load(std::memory_order_relaxed);
+
+    Slot* victim = nullptr;
+    int victim_worth = 0;
+    for (Slot& slot : cluster.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if ((check ^ data) == key) {
+            // Same position: keep a deeper result from this search unless the
+            // new one is exact.
+            if (entry.bound != Bound::EXACT && generationOf(data) == generation && depthOf(data) > entry.depth) {
+                return;
+            }
+            victim = &slot;
+            break;
+        }
+        if (boundOf(data) == Bound::NONE) {
+            victim = &slot;
+            break;
+        }
+
+        // Stale entries lose 8 plies of worth per search they have aged.
+        int age = (generation - generationOf(data)) & kGenerationMask;
+        int worth = depthOf(data) - 8 * age;
+        if (!victim || worth < victim_worth) {
+            victim = &slot;
+            victim_worth = worth;
+        }
+    }
+
+    uint64_t data = pack(entry, generation);
+    victim->data.store(data, std::memory_order_relaxed);
+    victim->check.store(key ^ data, std::memory_order_relaxed);
+}
+
+void TranspositionTable::addStats(uint64_t probes, uint64_t hits, uint64_t stores) {
+    probes_.fetch_add(probes, std::memory_order_relaxed);
+    hits_.fetch_add(hits, std::memory_order_relaxed);
+    stores_.fetch_add(stores, std::memory_order_relaxed);
+}
+
+TranspositionTable::Stats TranspositionTable::stats() const {
+    Stats stats;
+    stats.probes = probes_.load(std::memory_order_relaxed);
+    stats.hits = hits_.load(std::memory_order_relaxed);
+    stats.stores = stores_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void TranspositionTable::resetStats() {
+    probes_.store(0, std::memory_order_relaxed);
+    hits_.store(0, std::memory_order_relaxed);
+    stores_.store(0, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const {
+    uint8_t generation = generation_.load(std::memory_order_relaxed);
+    size_t sample = std::min<size_t>(clusters_.size(), 250);
+    int used = 0;
+    for (size_t i = 0; i < sample; i++) {
+        for (const Slot& slot : clusters_[i].slots) {
+            uint64_t data = slot.data.load(std::memory_order_relaxed);
+            used += boundOf(data) != Bound::NONE && generationOf(data) == generation;
+        }
+    }
+    return static_cast<int>(used * 1000 / (sample * kClusterSize));
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../core/chess_types.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class Bound : uint8_t {
+    NONE,
+    UPPER,
+    LOWER,
+    EXACT
+};
+
+struct TTEntry {
+    int score = 0;
+    int depth = 0;
+    Bound bound = Bound::NONE;
+    // Best action found; piece id 0 means waiting was best.
+    uint32_t piece_id = 0;
+    int to_square = 0;
+};
+
+// Fixed-size hash table of search results shared by any number of search
+// threads without locks. Each slot stores `key ^ data` next to `data`; a
+// reader that races a writer sees a mismatched pair and treats it as a miss,
+// so torn entries are never returned.
+//
+// Slots are grouped four to a 64-byte cluster, one cache line per probe.
+// Replacement prefers empty slots, then entries from older searches, then
+// shallower ones. Call newSearch() once per decision to age old entries.
+class TranspositionTable {
+public:
+    struct Stats {
+        uint64_t probes = 0;
+        uint64_t hits = 0;
+        uint64_t stores = 0;
+
+        double hitRate() const { return probes ? static_cast<double>(hits) / probes : 0.0; }
+    };
+
+    explicit TranspositionTable(size_t megabytes = 16);
+
+    // Drops all entries and reallocates; not safe while searches run.
+    void resize(size_t megabytes);
+    void clear();
+    void newSearch();
+
+    bool probe(uint64_t key, TTEntry& entry) const;
+    void store(uint64_t key, const TTEntry& entry);
+
+    // Searches report their probe counts in bulk to keep shared counters
+    // off the hot path.
+    void addStats(uint64_t probes, uint64_t hits, uint64_t stores);
+    Stats stats() const;
+    void resetStats();
+
+    size_t sizeInBytes() const { return clusters_.size() * sizeof(Cluster); }
+    // Permille of sampled slots written during the current search.
+    int hashfull() const;
+
+private:
+    static constexpr int kClusterSize = 4;
+
+    struct Slot {
+        std::atomic<uint64_t> check;
+        std::atomic<uint64_t> data;
+    };
+
+    struct alignas(64) Cluster {
+        Slot slots[kClusterSize];
+    };
+
+    static_assert(sizeof(Cluster) == 64, "a cluster fills exactly one cache line");
+
+    const Cluster& clusterFor(uint64_t key) const {
+        return clusters_[key & (clusters_.size() - 1)];
+    }
+
+    Cluster& clusterFor(uint64_t key) {
+        return clusters_[key & (clusters_.size() - 1)];
+    }
+
+    std::vector<Cluster> clusters_;
+    std::atomic<uint8_t> generation_;
+
+    std::atomic<uint64_t> probes_;
+    std::atomic<uint64_t> hits_;
+    std::atomic<uint64_t> stores_;
+};
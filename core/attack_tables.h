@@ -0,0 +1,108 @@
+#pragma once
+#include "bitboard.h"
+#include <array>
+
+// Compile-time attack masks for the leaper pieces. A lookup replaces the
+// per-target row/column delta arithmetic the validator used to do.
+namespace attacks {
+
+using SquareTable = std::array<Bitboard, kSquareCount>;
+
+constexpr Bitboard stepMask(int square, const int (&offsets)[8][2]) {
+    Bitboard mask = 0;
+    Position from = squarePosition(square);
+    for (const auto& offset : offsets) {
+        int row = from.row + offset[0];
+        int col = from.col + offset[1];
+        if (isOnBoard(row, col)) {
+            mask |= squareBit(squareIndex(row, col));
+        }
+    }
+    return mask;
+}
+
+constexpr SquareTable makeKnightTable() {
+    constexpr int offsets[8][2] = {
+            {2, 1}, {1, 2}, {-1, 2}, {-2, 1}, {-2, -1}, {-1, -2}, {1, -2}, {2, -1}
+    };
+    SquareTable table{};
+    for (int square = 0; square < kSquareCount; square++) {
+        table[square] = stepMask(square, offsets);
+    }
+    return table;
+}
+
+constexpr SquareTable makeKingTable() {
+    constexpr int offsets[8][2] = {
+            {1, 0}, {1, 1}, {0, 1}, {-1, 1}, {-1, 0}, {-1, -1}, {0, -1}, {1, -1}
+    };
+    SquareTable table{};
+    for (int square = 0; square < kSquareCount; square++) {
+        table[square] = stepMask(square, offsets);
+    }
+    return table;
+}
+
+// Diagonal capture squares of a pawn standing on each square.
+constexpr SquareTable makePawnTable(PlayerColor color) {
+    int direction = color == PlayerColor::WHITE ? 1 : -1;
+    SquareTable table{};
+    for (int square = 0; square < kSquareCount; square++) {
+        Position from = squarePosition(square);
+        int row = from.row + direction;
+        for (int side = -1; side <= 1; side += 2) {
+            if (isOnBoard(row, from.col + side)) {
+                table[square] |= squareBit(squareIndex(row, from.col + side));
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr SquareTable kKnightAttacks = makeKnightTable();
+inline constexpr SquareTable kKingAttacks = makeKingTable();
+inline constexpr std::array<SquareTable, kColorCount> kPawnAttacks = {
+        makePawnTable(PlayerColor::WHITE), makePawnTable(PlayerColor::BLACK)
+};
+
+constexpr Bitboard knightAttacks(int square) {
+    return kKnightAttacks[square];
+}
+
+constexpr Bitboard kingAttacks(int square) {
+    return kKingAttacks[square];
+}
+
+constexpr Bitboard pawnAttacks(PlayerColor color, int square) {
+    return kPawnAttacks[colorIndex(color)][square];
+}
+
+constexpr int countBits(Bitboard bb) {
+    int count = 0;
+    for (; bb; bb &= bb - 1) {
+        count++;
+    }
+    return count;
+}
+
+constexpr int totalBits(const SquareTable& table) {
+    int total = 0;
+    for (Bitboard mask : table) {
+        total += countBits(mask);
+    }
+    return total;
+}
+
+static_assert(kKnightAttacks[squareIndex(0, 0)] == (squareBit(squareIndex(1, 2)) | squareBit(squareIndex(2, 1))),
+              "knight on a1 attacks b3 and c2");
+static_assert(countBits(kKnightAttacks[squareIndex(3, 3)]) == 8, "knight in the centre has 8 targets");
+static_assert(totalBits(kKnightAttacks) == 336, "knight move count over all squares");
+static_assert(countBits(kKingAttacks[squareIndex(7, 7)]) == 3, "king in the corner has 3 targets");
+static_assert(totalBits(kKingAttacks) == 420, "king move count over all squares");
+static_assert(kPawnAttacks[0][squareIndex(1, 4)] == (squareBit(squareIndex(2, 3)) | squareBit(squareIndex(2, 5))),
+              "white pawn on e2 attacks d3 and f3");
+static_assert(kPawnAttacks[1][squareIndex(6, 0)] == squareBit(squareIndex(5, 1)),
+              "black pawn on a7 attacks b6 only");
+static_assert(kPawnAttacks[0][squareIndex(7, 3)] == 0, "white pawn on the last rank attacks nothing");
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "chess_types.h"
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Square index layout: square = row * 8 + col, so a1 = 0, h1 = 7, a8 = 56.
+// Iterating squares in ascending order therefore visits the board row by row,
+// the same order the rest of the code walks Position grids in.
+using Bitboard = uint64_t;
+
+constexpr int kSquareCount = 64;
+constexpr int kColorCount = 2;
+constexpr int kPieceTypeCount = 6;
+
+constexpr bool isOnBoard(int row, int col) {
+    return row >= 0 && row < 8 && col >= 0 && col < 8;
+}
+
+constexpr bool isOnBoard(Position position) {
+    return isOnBoard(position.row, position.col);
+}
+
+constexpr int squareIndex(int row, int col) {
+    return row * 8 + col;
+}
+
+constexpr int squareIndex(Position position) {
+    return squareIndex(position.row, position.col);
+}
+
+constexpr Position squarePosition(int square) {
+    return {square / 8, square % 8};
+}
+
+constexpr Bitboard squareBit(int square) {
+    return Bitboard{1} << square;
+}
+
+constexpr Bitboard squareBit(Position position) {
+    return squareBit(squareIndex(position));
+}
+
+constexpr int colorIndex(PlayerColor color) {
+    return color == PlayerColor::WHITE ? 0 : 1;
+}
+
+constexpr int typeIndex(PieceType type) {
+    return static_cast<int>(type);
+}
+
+constexpr PlayerColor opponentColor(PlayerColor color) {
+    return color == PlayerColor::WHITE ? PlayerColor::BLACK : PlayerColor::WHITE;
+}
+
+inline int popCount(Bitboard bb) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(bb));
+#else
+    return __builtin_popcountll(bb);
+#endif
+}
+
+inline int lowestSquare(Bitboard bb) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bb);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bb);
+#endif
+}
+
+inline int popLowestSquare(Bitboard& bb) {
+    int square = lowestSquare(bb);
+    bb &= bb - 1;
+    return square;
+}
@@ -1,77 +1,99 @@
 #include "board.h"
+#include "zobrist.h"
+#include "piece_square_tables.h"
+#include "attack_tables.h"
+#include "sliding_attacks.h"
 #include <iostream>
 #include <vector>
 #include <algorithm>
+#include <cstdlib>
 
-Board::Board() : next_id_(1) {
+Board::Board() : cooling_bb_(0), hash_(0), psq_score_(), version_(1), attack_cache_(), next_id_(1) {
+    clear();
 }
 
-void Board::setupStandardPosition() {
-    pieces_.clear();
+void Board::clear() {
+    pieces_ = {};
+    mailbox_.fill(0);
+    std::fill(std::begin(color_bb_), std::end(color_bb_), Bitboard{0});
+    std::fill(std::begin(type_bb_), std::end(type_bb_), Bitboard{0});
+    cooling_bb_ = 0;
+    hash_ = 0;
+    std::fill(std::begin(psq_score_), std::end(psq_score_), 0);
+    version_++;
     next_id_ = 1;
+}
 
-    for (int col = 0; col < 8; col++) {
-        Piece pawn;
-        pawn.id = next_id_++;
-        pawn.type = PieceType::PAWN;
-        pawn.color = PlayerColor::WHITE;
-        pawn.position = {1, col};
-        pawn.captured = false;
-        pawn.moved = false;
-        pawn.cooldown_ticks_remaining = 0;
-        pieces_[pawn.id] = pawn;
-    }
-
-    PieceType white_pieces[8] = {
+void Board::addPiece(PieceType type, PlayerColor color, Position position) {
+    Piece& piece = pieces_[next_id_ - 1];
+    piece.id = next_id_++;
+    piece.type = type;
+    piece.color = color;
+    piece.position = position;
+    piece.captured = false;
+    piece.moved = false;
+    piece.cooldown_ticks_remaining = 0;
+    placeOnSquare(piece);
+}
+
+Piece* Board::findMutablePiece(uint32_t id) {
+    if (id == 0 || id >= next_id_) {
+        return nullptr;
+    }
+    return &pieces_[id - 1];
+}
+
+void Board::placeOnSquare(const Piece& piece) {
+    int square = squareIndex(piece.position);
+    Bitboard bit = squareBit(square);
+    color_bb_[colorIndex(piece.color)] |= bit;
+    type_bb_[typeIndex(piece.type)] |= bit;
+    mailbox_[square] = piece.id;
+    if (piece.cooldown_ticks_remaining > 0) {
+        cooling_bb_ |= bit;
+    }
+    hash_ ^= zobrist::pieceKey(piece);
+    psq_score_[colorIndex(piece.color)] += eval::pieceSquare(piece.color, piece.type, square);
+}
+
+void Board::removeFromSquare(const Piece& piece) {
+    int square = squareIndex(piece.position);
+    Bitboard bit = squareBit(square);
+    color_bb_[colorIndex(piece.color)] &= ~bit;
+    type_bb_[typeIndex(piece.type)] &= ~bit;
+    mailbox_[square] = 0;
+    cooling_bb_ &= ~bit;
+    hash_ ^= zobrist::pieceKey(piece);
+    psq_score_[colorIndex(piece.color)] -= eval::pieceSquare(piece.color, piece.type, square);
+}
+
+void Board::setupStandardPosition() {
+    clear();
+
+    PieceType back_rank[8] = {
             PieceType::ROOK, PieceType::KNIGHT, PieceType::BISHOP, PieceType::QUEEN,
             PieceType::KING, PieceType::BISHOP, PieceType::KNIGHT, PieceType::ROOK
     };
 
     for (int col = 0; col < 8; col++) {
-        Piece piece;
-        piece.id = next_id_++;
-        piece.type = white_pieces[col];
-        piece.color = PlayerColor::WHITE;
-        piece.position = {0, col};
-        piece.captured = false;
-        piece.moved = false;
-        piece.cooldown_ticks_remaining = 0;
-        pieces_[piece.id] = piece;
+        addPiece(PieceType::PAWN, PlayerColor::WHITE, {1, col});
     }
 
     for (int col = 0; col < 8; col++) {
-        Piece pawn;
-        pawn.id = next_id_++;
-        pawn.type = PieceType::PAWN;
-        pawn.color = PlayerColor::BLACK;
-        pawn.position = {6, col};
-        pawn.captured = false;
-        pawn.moved = false;
-        pawn.cooldown_ticks_remaining = 0;
-        pieces_[pawn.id] = pawn;
-    }
-
-    PieceType black_pieces[8] = {
-            PieceType::ROOK, PieceType::KNIGHT, PieceType::BISHOP, PieceType::QUEEN,
-            PieceType::KING, PieceType::BISHOP, PieceType::KNIGHT, PieceType::ROOK
-    };
+        addPiece(back_rank[col], PlayerColor::WHITE, {0, col});
+    }
 
     for (int col = 0; col < 8; col++) {
-        Piece piece;
-        piece.id = next_id_++;
-        piece.type = black_pieces[col];
-        piece.color = PlayerColor::BLACK;
-        piece.position = {7, col};
-        piece.captured = false;
-        piece.moved = false;
-        piece.cooldown_ticks_remaining = 0;
-        pieces_[piece.id] = piece;
+        addPiece(PieceType::PAWN, PlayerColor::BLACK, {6, col});
+    }
+
+    for (int col = 0; col < 8; col++) {
+        addPiece(back_rank[col], PlayerColor::BLACK, {7, col});
     }
 }
 
 bool Board::setupFromFEN(const std::string& fen) {
-    pieces_.clear();
-    next_id_ = 1;
+    clear();
 
     int row = 7;
     int col = 0;
@@ -92,30 +114,26 @@ bool Board::setupFromFEN(const std::string& fen) {
         else {
             if (col >= 8) return false;
 
-            Piece piece;
-            piece.id = next_id_++;
-            piece.position = {row, col};
-            piece.captured = false;
-            piece.moved = false;
-            piece.cooldown_ticks_remaining = 0;
+            PieceType type;
+            PlayerColor color;
 
             switch (ch) {
-                case 'P': piece.type = PieceType::PAWN; piece.color = PlayerColor::WHITE; break;
-                case 'N': piece.type = PieceType::KNIGHT; piece.color = PlayerColor::WHITE; break;
-                case 'B': piece.type = PieceType::BISHOP; piece.color = PlayerColor::WHITE; break;
-                case 'R': piece.type = PieceType::ROOK; piece.color = PlayerColor::WHITE; break;
-                case 'Q': piece.type = PieceType::QUEEN; piece.color = PlayerColor::WHITE; break;
-                case 'K': piece.type = PieceType::KING; piece.color = PlayerColor::WHITE; break;
-                case 'p': piece.type = PieceType::PAWN; piece.color = PlayerColor::BLACK; break;
-                case 'n': piece.type = PieceType::KNIGHT; piece.color = PlayerColor::BLACK; break;
-                case 'b': piece.type = PieceType::BISHOP; piece.color = PlayerColor::BLACK; break;
-                case 'r': piece.type = PieceType::ROOK; piece.color = PlayerColor::BLACK; break;
-                case 'q': piece.type = PieceType::QUEEN; piece.color = PlayerColor::BLACK; break;
-                case 'k': piece.type = PieceType::KING; piece.color = PlayerColor::BLACK; break;
+                case 'P': type = PieceType::PAWN; color = PlayerColor::WHITE; break;
+                case 'N': type = PieceType::KNIGHT; color = PlayerColor::WHITE; break;
+                case 'B': type = PieceType::BISHOP; color = PlayerColor::WHITE; break;
+                case 'R': type = PieceType::ROOK; color = PlayerColor::WHITE; break;
+                case 'Q': type = PieceType::QUEEN; color = PlayerColor::WHITE; break;
+                case 'K': type = PieceType::KING; color = PlayerColor::WHITE; break;
+                case 'p': type = PieceType::PAWN; color = PlayerColor::BLACK; break;
+                case 'n': type = PieceType::KNIGHT; color = PlayerColor::BLACK; break;
+                case 'b': type = PieceType::BISHOP; color = PlayerColor::BLACK; break;
+                case 'r': type = PieceType::ROOK; color = PlayerColor::BLACK; break;
+                case 'q': type = PieceType::QUEEN; color = PlayerColor::BLACK; break;
+                case 'k': type = PieceType::KING; color = PlayerColor::BLACK; break;
                 default: return false;
             }
 
-            pieces_[piece.id] = piece;
+            addPiece(type, color, {row, col});
             col++;
         }
     }
@@ -127,76 +145,124 @@ bool Board::setupFromFEN(const std::string& fen) {
     return true;
 }
 
-std::optional<Piece> Board::getPieceAt(Position position) const {
-    for (const auto& [id, piece] : pieces_) {
-        if (!piece.captured && piece.position == position) {
-            return piece;
+void Board::setupFromPieces(const Piece* pieces, size_t count) {
+    clear();
+    for (size_t i = 0; i < count && i < pieces_.size(); i++) {
+        Piece& piece = pieces_[i];
+        piece = pieces[i];
+        piece.id = next_id_++;
+        if (!piece.captured) {
+            placeOnSquare(piece);
         }
     }
+}
+
+std::optional<Piece> Board::getPieceAt(Position position) const {
+    const Piece* piece = findPieceAt(position);
+    if (piece) {
+        return *piece;
+    }
     return std::nullopt;
 }
 
 std::optional<Piece> Board::getPieceById(uint32_t id) const {
-    auto it = pieces_.find(id);
-    if (it != pieces_.end()) {
-        return it->second;
+    const Piece* piece = findPiece(id);
+    if (piece) {
+        return *piece;
     }
     return std::nullopt;
 }
 
+const Piece* Board::findPiece(uint32_t id) const {
+    if (id == 0 || id >= next_id_) {
+        return nullptr;
+    }
+    return &pieces_[id - 1];
+}
+
+const Piece* Board::findPieceAt(Position position) const {
+    if (!isOnBoard(position)) {
+        return nullptr;
+    }
+    uint32_t id = mailbox_[squareIndex(position)];
+    return id ? &pieces_[id - 1] : nullptr;
+}
+
 bool Board::movePiece(uint32_t id, Position to) {
-    auto it = pieces_.find(id);
-    if (it == pieces_.end() || it->second.captured) {
+    Piece* piece = findMutablePiece(id);
+    if (!piece || piece->captured || !isOnBoard(to)) {
         return false;
     }
 
-    Position old_pos = it->second.position;
+    version_++;
 
-    auto target_piece = getPieceAt(to);
-    if (target_piece && target_piece->color != it->second.color) {
-        capturePieceAt(to);
+    uint32_t target_id = mailbox_[squareIndex(to)];
+    if (target_id == id) {
+        removeFromSquare(*piece);
+        piece->moved = true;
+        placeOnSquare(*piece);
+        return true;
+    }
+    if (target_id) {
+        Piece& target_piece = pieces_[target_id - 1];
+        if (target_piece.color == piece->color) {
+            return false;
+        }
+        removeFromSquare(target_piece);
+        target_piece.captured = true;
     }
 
-    it->second.position = to;
-    it->second.moved = true;
+    removeFromSquare(*piece);
+    piece->position = to;
+    piece->moved = true;
+    placeOnSquare(*piece);
 
     return true;
 }
 
 bool Board::capturePiece(uint32_t id) {
-    auto it = pieces_.find(id);
-    if (it == pieces_.end() || it->second.captured) {
+    Piece* piece = findMutablePiece(id);
+    if (!piece || piece->captured) {
         return false;
     }
 
-    it->second.captured = true;
+    version_++;
+    removeFromSquare(*piece);
+    piece->captured = true;
     return true;
 }
 
 void Board::capturePieceAt(Position pos) {
-    for (auto& [id, piece] : pieces_) {
-        if (!piece.captured && piece.position == pos) {
-            piece.captured = true;
-            break;
-        }
+    if (!isOnBoard(pos)) {
+        return;
+    }
+    uint32_t id = mailbox_[squareIndex(pos)];
+    if (id) {
+        capturePiece(id);
     }
 }
 
 bool Board::setPieceCooldown(uint32_t id, int cooldown) {
-    auto it = pieces_.find(id);
-    if (it == pieces_.end() || it->second.captured) {
+    Piece* piece = findMutablePiece(id);
+    if (!piece || piece->captured) {
         return false;
     }
 
-    it->second.cooldown_ticks_remaining = cooldown;
+    version_++;
+    hash_ ^= zobrist::coolingKey(*piece);
+    piece->cooldown_ticks_remaining = cooldown;
+    hash_ ^= zobrist::coolingKey(*piece);
+    Bitboard bit = squareBit(piece->position);
+    cooling_bb_ = cooldown > 0 ? cooling_bb_ | bit : cooling_bb_ & ~bit;
     return true;
 }
 
 std::vector<Piece> Board::getAllPieces(bool include_captured) const {
     std::vector<Piece> result;
-    result.reserve(pieces_.size());
+    result.reserve(next_id_ - 1);
 
-    for (const auto& [id, piece] : pieces_) {
+    for (uint32_t id = 1; id < next_id_; id++) {
+        const Piece& piece = pieces_[id - 1];
         if (include_captured || !piece.captured) {
             result.push_back(piece);
         }
@@ -208,7 +274,8 @@ std::vector<Piece> Board::getAllPieces(bool include_captured) const {
 std::vector<Piece> Board::getPlayerPieces(PlayerColor color, bool include_captured) const {
     std::vector<Piece> result;
 
-    for (const auto& [id, piece] : pieces_) {
+    for (uint32_t id = 1; id < next_id_; id++) {
+        const Piece& piece = pieces_[id - 1];
         if (piece.color == color && (include_captured || !piece.captured)) {
             result.push_back(piece);
         }
@@ -218,36 +285,223 @@ std::vector<Piece> Board::getPlayerPieces(PlayerColor color, bool include_captur
 }
 
 void Board::decrementCooldowns() {
-    int updated = 0;
-
-    for (auto& [id, piece] : pieces_) {
+    bool changed = false;
+    for (uint32_t id = 1; id < next_id_; id++) {
+        Piece& piece = pieces_[id - 1];
         if (piece.cooldown_ticks_remaining > 0) {
             piece.cooldown_ticks_remaining--;
-            updated++;
+            changed = true;
+            if (piece.cooldown_ticks_remaining == 0 && !piece.captured) {
+                hash_ ^= zobrist::kKeys.cooling[squareIndex(piece.position)];
+                cooling_bb_ &= ~squareBit(piece.position);
+            }
         }
     }
+
+    if (changed) {
+        version_++;
+    }
 }
 
-int Board::countKings(PlayerColor color) const {
-    int count = 0;
-    for (const auto& [id, piece] : pieces_) {
-        if (!piece.captured && piece.type == PieceType::KING && piece.color == color) {
-            count++;
+void Board::advanceCooldowns(int ticks) {
+    version_++;
+    for (uint32_t id = 1; id < next_id_; id++) {
+        Piece& piece = pieces_[id - 1];
+        if (piece.captured) {
+            continue;
+        }
+        bool was_cooling = piece.cooldown_ticks_remaining > 0;
+        piece.cooldown_ticks_remaining -= ticks;
+        if (was_cooling != (piece.cooldown_ticks_remaining > 0)) {
+            hash_ ^= zobrist::kKeys.cooling[squareIndex(piece.position)];
+            cooling_bb_ ^= squareBit(piece.position);
+        }
+    }
+}
+
+int Board::computePsqScore(PlayerColor color) const {
+    int score = 0;
+    for (uint32_t id = 1; id < next_id_; id++) {
+        const Piece& piece = pieces_[id - 1];
+        if (!piece.captured && piece.color == color) {
+            score += eval::pieceSquare(piece.color, piece.type, squareIndex(piece.position));
+        }
+    }
+    return score;
+}
+
+uint64_t Board::computeHash() const {
+    uint64_t hash = 0;
+    for (uint32_t id = 1; id < next_id_; id++) {
+        const Piece& piece = pieces_[id - 1];
+        if (!piece.captured) {
+            hash ^= zobrist::pieceKey(piece);
         }
     }
-    return count;
+    return hash;
+}
+
+Bitboard Board::attackedBy(PlayerColor color, bool ready_only) const {
+    AttackCache& cache = attack_cache_[colorIndex(color)][ready_only ? 1 : 0];
+    if (cache.version != version_) {
+        cache.squares = computeAttacks(color, ready_only);
+        cache.version = version_;
+    }
+    return cache.squares;
+}
+
+Bitboard Board::computeAttacks(PlayerColor color, bool ready_only) const {
+    Bitboard occupied = occupancy();
+    Bitboard attacked = 0;
+    Bitboard own = colorOccupancy(color);
+
+    while (own) {
+        int square = popLowestSquare(own);
+        const Piece& piece = pieces_[mailbox_[square] - 1];
+        if (ready_only && piece.cooldown_ticks_remaining > 0) {
+            continue;
+        }
+
+        switch (piece.type) {
+            case PieceType::PAWN:
+                attacked |= attacks::pawnAttacks(color, square);
+                break;
+            case PieceType::KNIGHT:
+                attacked |= attacks::knightAttacks(square);
+                break;
+            case PieceType::BISHOP:
+                attacked |= attacks::bishopAttacks(square, occupied);
+                break;
+            case PieceType::ROOK:
+                attacked |= attacks::rookAttacks(square, occupied);
+                break;
+            case PieceType::QUEEN:
+                attacked |= attacks::queenAttacks(square, occupied);
+                break;
+            case PieceType::KING:
+                attacked |= attacks::kingAttacks(square);
+                break;
+        }
+    }
+
+    return attacked;
+}
+
+Bitboard Board::attackersTo(int square, Bitboard occupied) const {
+    Bitboard diagonal = type_bb_[typeIndex(PieceType::BISHOP)] | type_bb_[typeIndex(PieceType::QUEEN)];
+    Bitboard straight = type_bb_[typeIndex(PieceType::ROOK)] | type_bb_[typeIndex(PieceType::QUEEN)];
+    Bitboard attackers =
+            (attacks::pawnAttacks(PlayerColor::BLACK, square) & pieces(PlayerColor::WHITE, PieceType::PAWN)) |
+            (attacks::pawnAttacks(PlayerColor::WHITE, square) & pieces(PlayerColor::BLACK, PieceType::PAWN)) |
+            (attacks::knightAttacks(square) & type_bb_[typeIndex(PieceType::KNIGHT)]) |
+            (attacks::kingAttacks(square) & type_bb_[typeIndex(PieceType::KING)]) |
+            (attacks::bishopAttacks(square, occupied) & diagonal) |
+            (attacks::rookAttacks(square, occupied) & straight);
+    return attackers & occupied;
+}
+
+int Board::countKings(PlayerColor color) const {
+    return popCount(pieces(color, PieceType::KING));
 }
 
 bool Board::promotePawn(uint32_t id, PieceType new_type) {
-    auto it = pieces_.find(id);
-    if (it == pieces_.end() || it->second.captured) {
+    Piece* piece = findMutablePiece(id);
+    if (!piece || piece->captured) {
         return false;
     }
 
-    if (it->second.type != PieceType::PAWN) {
+    if (piece->type != PieceType::PAWN) {
         return false;
     }
 
-    it->second.type = new_type;
+    version_++;
+    removeFromSquare(*piece);
+    piece->type = new_type;
+    placeOnSquare(*piece);
     return true;
 }
+
+MoveUndo Board::makeMove(uint32_t piece_id, Position to, int cooldown) {
+    Piece& piece = pieces_[piece_id - 1];
+    version_++;
+
+    MoveUndo undo;
+    undo.piece_id = piece_id;
+    undo.from = piece.position;
+    undo.prev_type = piece.type;
+    undo.prev_moved = piece.moved;
+    undo.prev_cooldown = piece.cooldown_ticks_remaining;
+    undo.captured_id = 0;
+    undo.rook_id = 0;
+    undo.rook_from = {0, 0};
+    undo.rook_prev_moved = false;
+    undo.rook_prev_cooldown = 0;
+
+    uint32_t target_id = mailbox_[squareIndex(to)];
+    if (target_id && target_id != piece_id) {
+        Piece& target_piece = pieces_[target_id - 1];
+        removeFromSquare(target_piece);
+        target_piece.captured = true;
+        undo.captured_id = target_id;
+    }
+
+    removeFromSquare(piece);
+    piece.position = to;
+    piece.moved = true;
+    piece.cooldown_ticks_remaining = cooldown;
+
+    if (piece.type == PieceType::PAWN && (to.row == 7 || to.row == 0)) {
+        piece.type = PieceType::QUEEN;
+    }
+    placeOnSquare(piece);
+
+    if (piece.type == PieceType::KING && !undo.prev_moved &&
+        to.row == undo.from.row && std::abs(to.col - undo.from.col) == 2) {
+        bool is_kingside = to.col > undo.from.col;
+        Position rook_pos = {to.row, is_kingside ? 7 : 0};
+        uint32_t rook_id = mailbox_[squareIndex(rook_pos)];
+
+        if (rook_id) {
+            Piece& rook = pieces_[rook_id - 1];
+            undo.rook_id = rook_id;
+            undo.rook_from = rook_pos;
+            undo.rook_prev_moved = rook.moved;
+            undo.rook_prev_cooldown = rook.cooldown_ticks_remaining;
+
+            removeFromSquare(rook);
+            rook.position = {to.row, undo.from.col + (is_kingside ? 1 : -1)};
+            rook.moved = true;
+            rook.cooldown_ticks_remaining = cooldown;
+            placeOnSquare(rook);
+        }
+    }
+
+    return undo;
+}
+
+void Board::unmakeMove(const MoveUndo& undo) {
+    version_++;
+
+    if (undo.rook_id) {
+        Piece& rook = pieces_[undo.rook_id - 1];
+        removeFromSquare(rook);
+        rook.position = undo.rook_from;
+        rook.moved = undo.rook_prev_moved;
+        rook.cooldown_ticks_remaining = undo.rook_prev_cooldown;
+        placeOnSquare(rook);
+    }
+
+    Piece& piece = pieces_[undo.piece_id - 1];
+    removeFromSquare(piece);
+    piece.position = undo.from;
+    piece.type = undo.prev_type;
+    piece.moved = undo.prev_moved;
+    piece.cooldown_ticks_remaining = undo.prev_cooldown;
+    placeOnSquare(piece);
+
+    if (undo.captured_id) {
+        Piece& captured = pieces_[undo.captured_id - 1];
+        captured.captured = false;
+        placeOnSquare(captured);
+    }
+}
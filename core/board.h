@@ -1,19 +1,77 @@
 #pragma once
 #include "chess_types.h"
+#include "bitboard.h"
+#include <array>
 #include <memory>
 #include <vector>
 #include <optional>
-#include <map>
+
+// Everything Board::makeMove() changed, so unmakeMove() can restore it exactly.
+struct MoveUndo {
+    uint32_t piece_id;
+    Position from;
+    PieceType prev_type;
+    bool prev_moved;
+    int prev_cooldown;
+
+    uint32_t captured_id;
+
+    uint32_t rook_id;
+    Position rook_from;
+    bool rook_prev_moved;
+    int rook_prev_cooldown;
+};
 
 class Board {
 public:
+    static constexpr int kMaxPieces = kSquareCount;
+
     Board();
     void setupStandardPosition();
     bool setupFromFEN(const std::string& fen);
+    // Pieces in id order starting from 1, captured ones included, so that
+    // every piece keeps its id.
+    void setupFromPieces(const Piece* pieces, size_t count);
 
     std::optional<Piece> getPieceAt(Position position) const;
     std::optional<Piece> getPieceById(uint32_t id) const;
 
+    // Allocation-free lookups for hot paths; nullptr when there is no such piece.
+    const Piece* findPiece(uint32_t id) const;
+    const Piece* findPieceAt(Position position) const;
+    uint32_t pieceIdAt(int square) const { return mailbox_[square]; }
+
+    Bitboard occupancy() const { return color_bb_[0] | color_bb_[1]; }
+    Bitboard colorOccupancy(PlayerColor color) const { return color_bb_[colorIndex(color)]; }
+    Bitboard typeOccupancy(PieceType type) const { return type_bb_[typeIndex(type)]; }
+    Bitboard pieces(PlayerColor color, PieceType type) const {
+        return color_bb_[colorIndex(color)] & type_bb_[typeIndex(type)];
+    }
+
+    // Zobrist key of the current position, maintained incrementally.
+    uint64_t hash() const { return hash_; }
+    uint64_t computeHash() const;
+
+    // Material plus piece-square score of one side, kept incrementally.
+    int psqScore(PlayerColor color) const { return psq_score_[colorIndex(color)]; }
+    int computePsqScore(PlayerColor color) const;
+
+    // Bumped by every mutation; never goes backwards, not even on unmakeMove.
+    uint64_t version() const { return version_; }
+
+    // Squares attacked by `color`, optionally only by pieces off cooldown.
+    // Computed lazily and cached until the next mutation. The cache lives in
+    // the Board, so concurrent readers must each use their own copy.
+    Bitboard attackedBy(PlayerColor color, bool ready_only = false) const;
+    bool isSquareAttacked(Position position, PlayerColor by, bool ready_only = false) const {
+        return attackedBy(by, ready_only) & squareBit(position);
+    }
+    // Pieces of either color attacking `square` when only `occupied` blocks
+    // sliders. Pieces outside `occupied` are left out.
+    Bitboard attackersTo(int square, Bitboard occupied) const;
+    // Squares of pieces still on cooldown, maintained incrementally.
+    Bitboard coolingPieces() const { return cooling_bb_; }
+
     bool movePiece(uint32_t id, Position to);
     bool capturePiece(uint32_t id);
     void capturePieceAt(Position pos);
@@ -24,11 +82,42 @@ public:
     std::vector<Piece> getPlayerPieces(PlayerColor color, bool include_captured = false) const;
 
     void decrementCooldowns();
+    // Moves every cooldown `ticks` forward without clamping at zero, so
+    // advanceCooldowns(-ticks) undoes it exactly. Used by search to step
+    // simulated time; a negative remainder simply means "ready".
+    void advanceCooldowns(int ticks);
     int countKings(PlayerColor color) const;
 
     bool promotePawn(uint32_t id, PieceType new_type);
 
+    // Plays an already validated move with full game semantics: capture,
+    // castling rook hop, promotion to queen and the mover's new cooldown.
+    MoveUndo makeMove(uint32_t piece_id, Position to, int cooldown = 0);
+    void unmakeMove(const MoveUndo& undo);
+
 private:
-    std::map<uint32_t, Piece> pieces_;
+    struct AttackCache {
+        uint64_t version;
+        Bitboard squares;
+    };
+
+    Bitboard computeAttacks(PlayerColor color, bool ready_only) const;
+
+    void clear();
+    void addPiece(PieceType type, PlayerColor color, Position position);
+    Piece* findMutablePiece(uint32_t id);
+    void placeOnSquare(const Piece& piece);
+    void removeFromSquare(const Piece& piece);
+
+    // Pieces are stored by id (slot id - 1); ids are handed out densely from 1.
+    std::array<Piece, kMaxPieces> pieces_;
+    std::array<uint32_t, kSquareCount> mailbox_;
+    Bitboard color_bb_[kColorCount];
+    Bitboard type_bb_[kPieceTypeCount];
+    Bitboard cooling_bb_;
+    uint64_t hash_;
+    int psq_score_[kColorCount];
+    uint64_t version_;
+    mutable AttackCache attack_cache_[kColorCount][2];
     uint32_t next_id_;
 };
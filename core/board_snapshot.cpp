@@ -0,0 +1,104 @@
+#include "board_snapshot.h"
+#include "zobrist.h"
+#include <algorithm>
+#include <limits>
+
+BoardSnapshot::BoardSnapshot()
+        : sequence_(0), hash_(0), color_bb_(), cooling_bb_(0), state_(GameState::NOT_STARTED),
+          white_cooldown_(0), black_cooldown_(0), piece_count_(0), mailbox_(), pieces_(), expiry_() {
+    expiry_.fill(CooldownSchedule::kNever);
+}
+
+void BoardSnapshot::capture(const Board& board, const CooldownSchedule& cooldowns, GameState state,
+                            int white_cooldown, int black_cooldown, uint64_t sequence) {
+    sequence_ = sequence;
+    hash_ = board.hash();
+    for (int color = 0; color < kColorCount; color++) {
+        color_bb_[color] = board.colorOccupancy(static_cast<PlayerColor>(color));
+    }
+    cooling_bb_ = board.coolingPieces();
+    state_ = state;
+    white_cooldown_ = white_cooldown;
+    black_cooldown_ = black_cooldown;
+
+    for (int square = 0; square < kSquareCount; square++) {
+        mailbox_[square] = static_cast<uint8_t>(board.pieceIdAt(square));
+    }
+
+    piece_count_ = 0;
+    while (const Piece* piece = board.findPiece(piece_count_ + 1)) {
+        PackedPiece& packed = pieces_[piece_count_++];
+        packed.square = static_cast<uint8_t>(squareIndex(piece->position));
+        packed.type = static_cast<uint8_t>(piece->type);
+        packed.color = static_cast<uint8_t>(piece->color);
+        packed.flags = (piece->captured ? kCaptured : 0) | (piece->moved ? kMoved : 0);
+        packed.cooldown_ticks = static_cast<uint16_t>(
+                std::clamp(piece->cooldown_ticks_remaining, 0, int(std::numeric_limits<uint16_t>::max())));
+    }
+    expiry_ = cooldowns.expiries();
+}
+
+std::optional<Piece> BoardSnapshot::pieceAt(Position position) const {
+    if (!isOnBoard(position)) {
+        return std::nullopt;
+    }
+    uint32_t id = mailbox_[squareIndex(position)];
+    if (!id) {
+        return std::nullopt;
+    }
+    return unpack(id);
+}
+
+std::optional<Piece> BoardSnapshot::pieceById(uint32_t id) const {
+    if (id == 0 || id > piece_count_) {
+        return std::nullopt;
+    }
+    return unpack(id);
+}
+
+std::vector<Piece> BoardSnapshot::pieces() const {
+    std::vector<Piece> result;
+    result.reserve(piece_count_);
+    forEachPiece([&result](const Piece& piece) { result.push_back(piece); });
+    return result;
+}
+
+uint64_t BoardSnapshot::hashAt(Time now) const {
+    uint64_t hash = hash_;
+    for (Bitboard cooling = cooling_bb_; cooling;) {
+        int square = popLowestSquare(cooling);
+        if (cooldownRemaining(mailbox_[square], now) == Time::zero()) {
+            hash ^= zobrist::kKeys.cooling[square];
+        }
+    }
+    return hash;
+}
+
+BoardSnapshot::Time BoardSnapshot::cooldownRemaining(uint32_t piece_id, Time now) const {
+    if (piece_id == 0 || piece_id > piece_count_) {
+        return Time::zero();
+    }
+    Time expiry = expiry_[piece_id - 1];
+    return expiry == CooldownSchedule::kNever || expiry <= now ? Time::zero() : expiry - now;
+}
+
+void BoardSnapshot::restore(Board& board) const {
+    std::array<Piece, Board::kMaxPieces> pieces;
+    for (uint32_t id = 1; id <= piece_count_; id++) {
+        pieces[id - 1] = unpack(id);
+    }
+    board.setupFromPieces(pieces.data(), piece_count_);
+}
+
+Piece BoardSnapshot::unpack(uint32_t id) const {
+    const PackedPiece& packed = pieces_[id - 1];
+    Piece piece;
+    piece.id = id;
+    piece.type = static_cast<PieceType>(packed.type);
+    piece.color = static_cast<PlayerColor>(packed.color);
+    piece.position = squarePosition(packed.square);
+    piece.captured = packed.flags & kCaptured;
+    piece.moved = packed.flags & kMoved;
+    piece.cooldown_ticks_remaining = packed.cooldown_ticks;
+    return piece;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "board.h"
+#include "cooldown_schedule.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Fixed-size picture of a game as published to readers: under a kilobyte,
+// no heap, copied in one pass from the board and never modified after
+// publication, so any number of threads can read it at once. Pieces carry
+// their cooldown ticks as of publication; cooldownRemaining() is exact at
+// any later time.
+class BoardSnapshot {
+public:
+    using Time = std::chrono::microseconds;
+
+    BoardSnapshot();
+
+    // Writer only, before publication.
+    void capture(const Board& board, const CooldownSchedule& cooldowns, GameState state,
+                 int white_cooldown, int black_cooldown, uint64_t sequence);
+
+    // Bumped once per publication.
+    uint64_t sequence() const { return sequence_; }
+    GameState state() const { return state_; }
+    int whiteCooldown() const { return white_cooldown_; }
+    int blackCooldown() const { return black_cooldown_; }
+    // Same as the board's hash() at capture time.
+    uint64_t hash() const { return hash_; }
+    // The hash once pieces whose cooldown has expired by `now` count as
+    // ready, as they do on a board recounted to `now`.
+    uint64_t hashAt(Time now) const;
+
+    Bitboard colorOccupancy(PlayerColor color) const { return color_bb_[colorIndex(color)]; }
+    Bitboard occupancy() const { return color_bb_[0] | color_bb_[1]; }
+    Bitboard coolingPieces() const { return cooling_bb_; }
+
+    std::optional<Piece> pieceAt(Position position) const;
+    std::optional<Piece> pieceById(uint32_t id) const;
+    // Pieces still on the board, in id order.
+    std::vector<Piece> pieces() const;
+    template <typename Visitor>
+    void forEachPiece(Visitor&& visit) const {
+        for (uint32_t id = 1; id <= piece_count_; id++) {
+            if (!(pieces_[id - 1].flags & kCaptured)) {
+                visit(unpack(id));
+            }
+        }
+    }
+
+    // Zero once the piece is ready, or if it has no cooldown.
+    Time cooldownRemaining(uint32_t piece_id, Time now) const;
+
+    // Rebuilds the full board, same ids and hash, for callers that search
+    // or validate moves on it.
+    void restore(Board& board) const;
+
+private:
+    static constexpr uint8_t kCaptured = 1;
+    static constexpr uint8_t kMoved = 2;
+
+    struct PackedPiece {
+        uint8_t square;
+        uint8_t type;
+        uint8_t color;
+        uint8_t flags;
+        // Clamped to fit; only whether it is zero has to be exact.
+        uint16_t cooldown_ticks;
+    };
+
+    Piece unpack(uint32_t id) const;
+
+    uint64_t sequence_;
+    uint64_t hash_;
+    Bitboard color_bb_[kColorCount];
+    Bitboard cooling_bb_;
+    GameState state_;
+    int white_cooldown_;
+    int black_cooldown_;
+    uint32_t piece_count_;
+    // Piece id on each square, 0 when empty.
+    std::array<uint8_t, kSquareCount> mailbox_;
+    std::array<PackedPiece, Board::kMaxPieces> pieces_;
+    std::array<Time, Board::kMaxPieces> expiry_;
+};
@@ -47,6 +47,12 @@ enum class AIDifficulty {
     EXPERT
 };
 
+enum class AIEngine {
+    HEURISTIC,
+    ALPHA_BETA,
+    MCTS
+};
+
 struct Piece {
     uint32_t id;
     PieceType type;
@@ -70,5 +76,7 @@ struct GameSettings {
     int tick_rate_ms;
     bool against_ai;
     std::optional<AIDifficulty> ai_difficulty;
+    // Overrides the engine the difficulty would pick.
+    std::optional<AIEngine> ai_engine;
     std::string fen_string;
 };
@@ -0,0 +1,73 @@
+#include "cooldown_schedule.h"
+#include <algorithm>
+#include <functional>
+
+CooldownSchedule::CooldownSchedule() : pending_(0) {
+    expiry_.fill(kNever);
+}
+
+void CooldownSchedule::clear() {
+    heap_.clear();
+    expiry_.fill(kNever);
+    pending_ = 0;
+}
+
+void CooldownSchedule::start(uint32_t piece_id, Time expiry) {
+    if (piece_id == 0 || piece_id > expiry_.size() || expiry == kNever) {
+        return;
+    }
+    Time& slot = expiry_[piece_id - 1];
+    if (slot == kNever) {
+        pending_++;
+    }
+    slot = expiry;
+    heap_.push_back(Entry{expiry, piece_id});
+    std::push_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+}
+
+void CooldownSchedule::cancel(uint32_t piece_id) {
+    if (piece_id == 0 || piece_id > expiry_.size() || expiry_[piece_id - 1] == kNever) {
+        return;
+    }
+    expiry_[piece_id - 1] = kNever;
+    pending_--;
+}
+
+CooldownSchedule::Time CooldownSchedule::expiry(uint32_t piece_id) const {
+    if (piece_id == 0 || piece_id > expiry_.size()) {
+        return kNever;
+    }
+    return expiry_[piece_id - 1];
+}
+
+CooldownSchedule::Time CooldownSchedule::remaining(uint32_t piece_id, Time now) const {
+    Time at = expiry(piece_id);
+    return at == kNever || at <= now ? Time::zero() : at - now;
+}
+
+CooldownSchedule::Time CooldownSchedule::nextExpiry() {
+    dropStale();
+    return heap_.empty() ? kNever : heap_.front().expiry;
+}
+
+void CooldownSchedule::popExpired(Time now, std::vector<uint32_t>& ready) {
+    for (dropStale(); !heap_.empty() && heap_.front().expiry <= now; dropStale()) {
+        uint32_t piece_id = heap_.front().piece_id;
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+        heap_.pop_back();
+        expiry_[piece_id - 1] = kNever;
+        pending_--;
+        ready.push_back(piece_id);
+    }
+}
+
+bool CooldownSchedule::isStale(const Entry& entry) const {
+    return expiry_[entry.piece_id - 1] != entry.expiry;
+}
+
+void CooldownSchedule::dropStale() {
+    while (!heap_.empty() && isStale(heap_.front())) {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<Entry>());
+        heap_.pop_back();
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include "board.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Absolute cooldown expiry times of the pieces of one game, on the game
+// clock. Whether a piece is ready is a comparison with the current time, so
+// nothing has to run while pieces wait; the soonest expiry sits on top of a
+// min-heap and tells the game when it next needs to wake up.
+//
+// Restarting or cancelling a cooldown leaves the old heap entry behind; it
+// is recognised as stale and dropped when it reaches the top.
+class CooldownSchedule {
+public:
+    using Time = std::chrono::microseconds;
+    static constexpr Time kNever = Time::max();
+
+    CooldownSchedule();
+
+    void clear();
+    // Replaces any cooldown the piece already had.
+    void start(uint32_t piece_id, Time expiry);
+    void cancel(uint32_t piece_id);
+
+    // kNever when the piece has no cooldown pending.
+    Time expiry(uint32_t piece_id) const;
+    bool ready(uint32_t piece_id, Time now) const { return remaining(piece_id, now) == Time::zero(); }
+    // Zero once the piece is ready.
+    Time remaining(uint32_t piece_id, Time now) const;
+
+    // Soonest pending expiry, or kNever.
+    Time nextExpiry();
+    // Removes every cooldown that has expired by `now` and appends the ids
+    // of those pieces to `ready`, soonest first.
+    void popExpired(Time now, std::vector<uint32_t>& ready);
+
+    size_t pending() const { return pending_; }
+    // Expiry of every piece, indexed by id - 1.
+    const std::array<Time, Board::kMaxPieces>& expiries() const { return expiry_; }
+
+private:
+    struct Entry {
+        Time expiry;
+        uint32_t piece_id;
+
+        bool operator>(const Entry& other) const { return expiry > other.expiry; }
+    };
+
+    bool isStale(const Entry& entry) const;
+    void dropStale();
+
+    std::vector<Entry> heap_;
+    std::array<Time, Board::kMaxPieces> expiry_;
+    size_t pending_;
+};
@@ -1,250 +1,403 @@
 #include "game.h"
+#include "../utility/condition_wait.h"
+#include <algorithm>
 #include <iostream>
 
-Game::Game(std::function<void(GameState)> state_change_callback)
+namespace {
+
+// Attempts to help drain before a blocked caller goes to sleep.
+constexpr int kSpinsBeforeSleep = 64;
+
+std::atomic<uint64_t> next_cache_id{1};
+
+// The board last rebuilt on this thread, so looking up the moves of one
+// piece after another does not rebuild it each time. The hash includes
+// the cooldowns that expired since publication.
+struct BoardCache {
+    uint64_t game = 0;
+    uint64_t sequence = 0;
+    uint64_t hash = 0;
+    Board board;
+};
+
+thread_local BoardCache board_cache;
+
+// Whole ticks left of `remaining`, rounded up.
+int ticksLeft(ClockSource::Time remaining, ClockSource::Time tick) {
+    return static_cast<int>((remaining + tick - ClockSource::Time(1)) / tick);
+}
+
+}
+
+Game::Game(std::function<void(GameState)> state_change_callback, std::unique_ptr<ClockSource> clock)
         : state_(GameState::NOT_STARTED),
-          state_change_callback_(state_change_callback),
           white_cooldown_(10),
           black_cooldown_(10),
-          against_ai_(false) {
+          against_ai_(false),
+          sequence_(0),
+          clock_(clock ? std::move(clock) : std::make_unique<SchedulerClock>()),
+          state_change_callback_(state_change_callback),
+          queued_(0),
+          draining_(false),
+          sleepers_(0),
+          cache_id_(next_cache_id.fetch_add(1)) {
+    publish();
 }
 
-void Game::applySettings(const GameSettings& settings) {
-    white_cooldown_ = settings.white_cooldown_ticks;
-    black_cooldown_ = settings.black_cooldown_ticks;
-    timer_.setTickRate(settings.tick_rate_ms);
-    against_ai_ = settings.against_ai;
+Game::~Game() {
+    clock_->stop();
+}
 
-    if (settings.fen_string.empty() || settings.fen_string == "standard") {
-        board_.setupStandardPosition();
-    } else {
-        if (!board_.setupFromFEN(settings.fen_string)) {
-            std::cerr << "Invalid FEN string, using standard position" << std::endl;
-            board_.setupStandardPosition();
-        }
-    }
+void Game::applySettings(const GameSettings& settings) {
+    Command command;
+    command.kind = Command::Kind::SETTINGS;
+    command.settings = settings;
+    execute(std::move(command));
+}
 
-    state_ = GameState::WAITING_FOR_SETTINGS;
+void Game::start() {
+    Command command;
+    command.kind = Command::Kind::START;
+    execute(std::move(command));
+}
 
-    if (state_change_callback_) {
-        state_change_callback_(state_);
-    }
+void Game::pause() {
+    Command command;
+    command.kind = Command::Kind::PAUSE;
+    execute(std::move(command));
 }
 
-void Game::start() {
-    if (state_ == GameState::WAITING_FOR_SETTINGS || state_ == GameState::NOT_STARTED) {
-        state_ = GameState::ACTIVE;
+void Game::resume() {
+    Command command;
+    command.kind = Command::Kind::RESUME;
+    execute(std::move(command));
+}
 
-        timer_.start([this]() { this->tick(); });
+void Game::reset() {
+    Command command;
+    command.kind = Command::Kind::RESET;
+    execute(std::move(command));
+}
 
-        if (state_change_callback_) {
-            state_change_callback_(state_);
-        }
+bool Game::makeMove(uint32_t piece_id, Position target) {
+    // Cheap early out that needs no trip through the queue.
+    if (getState() != GameState::ACTIVE) {
+        return false;
     }
+    Command command;
+    command.kind = Command::Kind::MOVE;
+    command.piece_id = piece_id;
+    command.target = target;
+    return execute(std::move(command));
 }
 
-void Game::pause() {
-    if (state_ == GameState::ACTIVE) {
-        state_ = GameState::PAUSED;
+void Game::wake() {
+    // Runs on the clock's thread, which Game may be waiting on in
+    // clock_->stop(), so it must never wait itself.
+    commands_.push(Command{});
+    queued_.fetch_add(1);
+    drain();
+}
+
+bool Game::execute(Command command) {
+    // A state change callback issuing a command is already the writer.
+    if (drainer_.load() == std::this_thread::get_id()) {
+        return apply(command);
+    }
 
-        timer_.stop();
+    Completion completion;
+    command.completion = &completion;
+    commands_.push(std::move(command));
+    queued_.fetch_add(1);
 
-        if (state_change_callback_) {
-            state_change_callback_(state_);
+    for (int spin = 0; !completion.done.load(std::memory_order_acquire); spin++) {
+        if (drain()) {
+            continue;
+        }
+        if (spin < kSpinsBeforeSleep) {
+            std::this_thread::yield();
+            continue;
         }
+        // Someone else is draining and, finding queued_ non-zero when it
+        // stops, picks up our command, so sleeping here cannot strand it.
+        sleepers_.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(completion_mutex_);
+            blockUntil(completed_, lock, [&completion] { return completion.done.load(); });
+        }
+        sleepers_.fetch_sub(1);
     }
+    return completion.result;
 }
 
-void Game::resume() {
-    if (state_ == GameState::PAUSED) {
-        state_ = GameState::ACTIVE;
-
-        timer_.start([this]() { this->tick(); });
+bool Game::drain() {
+    bool drained = false;
+    while (!draining_.exchange(true)) {
+        drained = true;
+        drainer_.store(std::this_thread::get_id());
+
+        Command command;
+        while (commands_.pop(command)) {
+            bool result = apply(command);
+            queued_.fetch_sub(1);
+            if (command.completion) {
+                command.completion->result = result;
+                // The waiter may return and free the completion right away.
+                command.completion->done.store(true);
+                if (sleepers_.load() > 0) {
+                    std::lock_guard<std::mutex> lock(completion_mutex_);
+                    completed_.notify_all();
+                }
+            }
+        }
 
-        if (state_change_callback_) {
-            state_change_callback_(state_);
+        drainer_.store(std::thread::id());
+        draining_.store(false);
+        // A producer that pushed after our last pop but saw us still
+        // draining has left its command to us.
+        if (queued_.load() == 0) {
+            break;
         }
     }
+    return drained;
 }
 
-void Game::reset() {
-    timer_.stop();
-
-    if (board_.getAllPieces().empty()) {
-        board_.setupStandardPosition();
+bool Game::apply(const Command& command) {
+    uint64_t published = sequence_;
+    bool result = true;
+    switch (command.kind) {
+        case Command::Kind::MOVE:
+            result = doMakeMove(command.piece_id, command.target);
+            break;
+        case Command::Kind::WAKE:
+            syncCooldowns(clock_->now());
+            break;
+        case Command::Kind::SETTINGS:
+            doApplySettings(command.settings);
+            break;
+        case Command::Kind::START:
+            result = doStart();
+            break;
+        case Command::Kind::PAUSE:
+            result = doPause();
+            break;
+        case Command::Kind::RESUME:
+            result = doResume();
+            break;
+        case Command::Kind::RESET:
+            result = doReset();
+            break;
     }
-
-    state_ = GameState::WAITING_FOR_SETTINGS;
-
-    if (state_change_callback_) {
-        state_change_callback_(state_);
+    // Once per command: setState() already published anything it changed.
+    if (sequence_ == published) {
+        publish();
     }
+    return result;
 }
 
-bool Game::makeMove(uint32_t piece_id, Position target) {
-    if (state_ != GameState::ACTIVE) {
-        return false;
+void Game::doApplySettings(const GameSettings& settings) {
+    white_cooldown_ = settings.white_cooldown_ticks;
+    black_cooldown_ = settings.black_cooldown_ticks;
+    clock_->setTickRate(settings.tick_rate_ms);
+    against_ai_ = settings.against_ai;
+
+    cooldowns_.clear();
+
+    if (settings.fen_string.empty() || settings.fen_string == "standard") {
+        board_.setupStandardPosition();
+    } else {
+        if (!board_.setupFromFEN(settings.fen_string)) {
+            std::cerr << "Invalid FEN string, using standard position" << std::endl;
+            board_.setupStandardPosition();
+        }
     }
 
-    auto piece_opt = board_.getPieceById(piece_id);
-    if (!piece_opt) {
+    setState(GameState::WAITING_FOR_SETTINGS);
+}
+
+bool Game::doStart() {
+    if (state_ != GameState::WAITING_FOR_SETTINGS && state_ != GameState::NOT_STARTED) {
         return false;
     }
+    state_ = GameState::ACTIVE;
+    clock_->start([this]() { this->wake(); });
+    setState(state_);
+    return true;
+}
 
-    if (piece_opt->cooldown_ticks_remaining > 0) {
+bool Game::doPause() {
+    if (state_ != GameState::ACTIVE) {
         return false;
     }
+    state_ = GameState::PAUSED;
+    clock_->stop();
+    setState(state_);
+    return true;
+}
 
-    if (!validator_.isValidMove(board_, piece_id, target)) {
+bool Game::doResume() {
+    if (state_ != GameState::PAUSED) {
         return false;
     }
+    state_ = GameState::ACTIVE;
+    clock_->start([this]() { this->wake(); });
+    setState(state_);
+    return true;
+}
 
-    if (isCastlingMove(*piece_opt, target)) {
-        handleCastling(piece_id, target);
-        return true;
-    }
+bool Game::doReset() {
+    clock_->stop();
 
-    if (board_.movePiece(piece_id, target)) {
-        checkPawnPromotion(piece_id, target);
-        applyCooldown(piece_id);
-        updateGameState();
-        return true;
+    if (board_.getAllPieces().empty()) {
+        board_.setupStandardPosition();
     }
 
-    return false;
+    setState(GameState::WAITING_FOR_SETTINGS);
+    return true;
 }
 
-void Game::checkPawnPromotion(uint32_t piece_id, Position target) {
-    auto piece_opt = board_.getPieceById(piece_id);
-    if (!piece_opt || piece_opt->type != PieceType::PAWN) {
-        return;
+bool Game::doMakeMove(uint32_t piece_id, Position target) {
+    if (state_ != GameState::ACTIVE) {
+        return false;
     }
 
-    bool is_last_rank = (piece_opt->color == PlayerColor::WHITE && target.row == 7) ||
-                        (piece_opt->color == PlayerColor::BLACK && target.row == 0);
-
-    if (is_last_rank) {
-        board_.promotePawn(piece_id, PieceType::QUEEN);
-    }
-}
+    ClockSource::Time now = clock_->now();
+    syncCooldowns(now);
 
-bool Game::isCastlingMove(const Piece& king, Position target) const {
-    if (king.moved) {
+    const Piece* piece = board_.findPiece(piece_id);
+    if (!piece) {
         return false;
     }
 
-    int col_diff = std::abs(target.col - king.position.col);
-    return col_diff == 2 && king.position.row == target.row;
-}
-
-bool Game::handleCastling(uint32_t king_id, Position target) {
-    auto king_opt = board_.getPieceById(king_id);
-    if (!king_opt || king_opt->moved) {
+    if (piece->cooldown_ticks_remaining > 0) {
         return false;
     }
 
-    const Piece& king = king_opt.value();
-
-    if (!isCastlingMove(king, target)) {
+    if (!validator_.isValidMove(board_, piece_id, target)) {
         return false;
     }
 
-    bool is_kingside = target.col > king.position.col;
-    int rook_col = is_kingside ? 7 : 0;
-
-    Position rook_pos = {king.position.row, rook_col};
-    auto rook_opt = board_.getPieceAt(rook_pos);
+    MoveUndo undo = board_.makeMove(piece_id, target, cooldownFor(piece->color));
+    cooldowns_.cancel(undo.captured_id);
+    syncCooldowns(now);
+    updateGameState();
+    return true;
+}
 
-    if (!rook_opt || rook_opt->type != PieceType::ROOK ||
-        rook_opt->color != king.color || rook_opt->moved) {
-        return false;
+void Game::setState(GameState state) {
+    state_ = state;
+    // Published before the callback runs, so it sees the new state.
+    publish();
+    if (state_change_callback_) {
+        state_change_callback_(state_);
     }
+}
 
-    int step = is_kingside ? 1 : -1;
-    for (int col = king.position.col + step; col != rook_col; col += step) {
-        Position pos = {king.position.row, col};
-        if (board_.getPieceAt(pos)) {
-            return false;
-        }
+std::vector<Position> Game::getValidMoves(uint32_t piece_id) const {
+    SnapshotRef snapshot = this->snapshot();
+    ClockSource::Time now = clock_->now();
+    uint64_t hash = snapshot->hashAt(now);
+    BoardCache& cache = board_cache;
+    if (cache.game != cache_id_ || cache.sequence != snapshot->sequence() || cache.hash != hash) {
+        cache.board = rebuildBoard(*snapshot, now);
+        cache.game = cache_id_;
+        cache.sequence = snapshot->sequence();
+        cache.hash = hash;
     }
+    return validator_.getValidMoves(cache.board, piece_id);
+}
 
-    uint32_t rook_id = rook_opt->id;
-    Position rook_target = {king.position.row, king.position.col + step};
-
-    if (!board_.movePiece(king_id, target)) {
-        return false;
+void Game::syncCooldowns(ClockSource::Time now) {
+    std::vector<uint32_t> ready;
+    cooldowns_.popExpired(now, ready);
+    for (uint32_t id : ready) {
+        board_.setPieceCooldown(id, 0);
     }
 
-    if (!board_.movePiece(rook_id, rook_target)) {
-        board_.movePiece(king_id, king.position);
-        return false;
+    ClockSource::Time tick = std::chrono::milliseconds(std::max(1, clock_->tickRate()));
+    for (Bitboard cooling = board_.coolingPieces(); cooling;) {
+        uint32_t id = board_.pieceIdAt(popLowestSquare(cooling));
+        const Piece* piece = board_.findPiece(id);
+        if (cooldowns_.expiry(id) == CooldownSchedule::kNever) {
+            cooldowns_.start(id, now + piece->cooldown_ticks_remaining * tick);
+            continue;
+        }
+        int ticks = ticksLeft(cooldowns_.remaining(id, now), tick);
+        if (ticks != piece->cooldown_ticks_remaining) {
+            board_.setPieceCooldown(id, ticks);
+        }
     }
 
-    applyCooldown(king_id);
-    applyCooldown(rook_id);
-
-    return true;
+    clock_->wakeAt(cooldowns_.nextExpiry());
 }
 
-std::vector<Position> Game::getValidMoves(uint32_t piece_id) const {
-    return validator_.getValidMoves(board_, piece_id);
+void Game::publish() {
+    snapshots_.prepare().capture(board_, cooldowns_, state_, white_cooldown_, black_cooldown_, ++sequence_);
+    snapshots_.publish();
 }
 
-void Game::tick() {
-    static int tick_counter = 0;
-    tick_counter++;
+Game::SnapshotRef Game::snapshot() const {
+    return snapshots_.acquire();
+}
 
-    board_.decrementCooldowns();
-    updateGameState();
+Board Game::getBoard() const {
+    SnapshotRef snapshot = this->snapshot();
+    return rebuildBoard(*snapshot, clock_->now());
 }
 
-Board& Game::getBoard() {
-    return board_;
+uint64_t Game::positionHash() const {
+    SnapshotRef snapshot = this->snapshot();
+    return snapshot->hashAt(clock_->now());
 }
 
-const Board& Game::getBoard() const {
-    return board_;
+Board Game::rebuildBoard(const BoardSnapshot& snapshot, ClockSource::Time now) const {
+    Board board;
+    snapshot.restore(board);
+
+    // The snapshot's ticks are as of its publication; recount them from the
+    // expiry times, which do not go stale.
+    ClockSource::Time tick = std::chrono::milliseconds(std::max(1, clock_->tickRate()));
+    for (Bitboard cooling = board.coolingPieces(); cooling;) {
+        uint32_t id = board.pieceIdAt(popLowestSquare(cooling));
+        int ticks = ticksLeft(snapshot.cooldownRemaining(id, now), tick);
+        if (ticks != board.findPiece(id)->cooldown_ticks_remaining) {
+            board.setPieceCooldown(id, ticks);
+        }
+    }
+    return board;
 }
 
 GameState Game::getState() const {
-    return state_;
+    return snapshot()->state();
 }
 
 int Game::getWhiteCooldown() const {
-    return white_cooldown_;
+    return snapshot()->whiteCooldown();
 }
 
 int Game::getBlackCooldown() const {
-    return black_cooldown_;
+    return snapshot()->blackCooldown();
+}
+
+int Game::getTickRate() const {
+    return clock_->tickRate();
+}
+
+ClockSource::Time Game::cooldownRemaining(uint32_t piece_id) const {
+    return snapshot()->cooldownRemaining(piece_id, clock_->now());
 }
 
 void Game::updateGameState() {
     if (board_.countKings(PlayerColor::WHITE) == 0) {
-        state_ = GameState::BLACK_WIN;
-        timer_.stop();
-        if (state_change_callback_) {
-            state_change_callback_(state_);
-        }
+        clock_->stop();
+        setState(GameState::BLACK_WIN);
     }
     else if (board_.countKings(PlayerColor::BLACK) == 0) {
-        state_ = GameState::WHITE_WIN;
-        timer_.stop();
-        if (state_change_callback_) {
-            state_change_callback_(state_);
-        }
-    }
-}
-
-void Game::applyCooldown(uint32_t piece_id) {
-    auto piece_opt = board_.getPieceById(piece_id);
-    if (!piece_opt) {
-        return;
+        clock_->stop();
+        setState(GameState::WHITE_WIN);
     }
-
-    int cooldown = (piece_opt->color == PlayerColor::WHITE) ? white_cooldown_ : black_cooldown_;
-    board_.setPieceCooldown(piece_id, cooldown);
 }
 
-void Game::checkGameOver() {
-    updateGameState();
+int Game::cooldownFor(PlayerColor color) const {
+    return (color == PlayerColor::WHITE) ? white_cooldown_ : black_cooldown_;
 }
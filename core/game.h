@@ -1,12 +1,47 @@
 #pragma once
 #include "board.h"
+#include "board_snapshot.h"
 #include "move_validator.h"
-#include "../utility/timer.h"
+#include "cooldown_schedule.h"
+#include "../utility/mpsc_queue.h"
+#include "../utility/snapshot_publisher.h"
+#include "../utility/scheduler.h"
+#include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
 
+// A running game, safe to use from any number of threads.
+//
+// Every change to the game - moves, clock wake-ups, start/pause/resume,
+// settings - is a command on a lock-free queue, and one thread at a time
+// applies them: whichever caller finds no one else doing so drains the
+// queue, its own command and everyone else's. Callers of the blocking
+// methods wait until their command has been applied, sleeping rather than
+// spinning if that takes a while; clock wake-ups are queued and return at
+// once.
+//
+// The state change callback runs on the thread that applied the command,
+// which may be a thread of the shared Scheduler running other games' timers
+// too. It must not block; it may call back into the game.
+//
+// After each command the writer publishes an immutable BoardSnapshot, and
+// every reader works from the latest one, so reads never see a half-made
+// move. Taking a snapshot is wait-free and the writer never waits for
+// readers. Accessors that bring cooldowns up to date also read the game
+// clock, which for every ClockSource here is a single atomic load.
 class Game {
 public:
-    Game(std::function<void(GameState)> state_change_callback = nullptr);
+    using SnapshotRef = SnapshotPublisher<BoardSnapshot>::Ref;
+
+    // `clock` is the game time; when none is given, a real-time clock on the
+    // process-wide Scheduler, so games do not each need a thread. Pass a
+    // ManualClock (and keep a pointer to it) to step the game by hand.
+    Game(std::function<void(GameState)> state_change_callback = nullptr,
+         std::unique_ptr<ClockSource> clock = nullptr);
+    ~Game();
 
     void applySettings(const GameSettings& settings);
     void start();
@@ -18,30 +53,89 @@ public:
     std::vector<Position> getValidMoves(uint32_t piece_id) const;
 
     GameState getState() const;
-    const Board& getBoard() const;
-    Board& getBoard();
+    // The game as of the latest command, held for as long as the Ref lives.
+    // The cheap way to look at the position every frame.
+    SnapshotRef snapshot() const;
+    // A full board rebuilt from the latest snapshot, with the remaining
+    // cooldown ticks brought up to date from the game clock, rounded up to
+    // whole ticks. For callers that search or validate moves on it.
+    Board getBoard() const;
+    // What getBoard().hash() would return, without building the board.
+    uint64_t positionHash() const;
 
     int getWhiteCooldown() const;
     int getBlackCooldown() const;
+    int getTickRate() const;
+    // Exact time until the piece may move again; zero when it is ready.
+    ClockSource::Time cooldownRemaining(uint32_t piece_id) const;
 
 private:
-    void tick();
-    void checkGameOver();
-    void updateGameState();
-    void applyCooldown(uint32_t piece_id);
+    struct Completion {
+        std::atomic<bool> done{false};
+        bool result = false;
+    };
 
-    void checkPawnPromotion(uint32_t piece_id, Position target);
-    bool handleCastling(uint32_t king_id, Position target);
-    bool isCastlingMove(const Piece& king, Position target) const;
+    struct Command {
+        enum class Kind { MOVE, WAKE, SETTINGS, START, PAUSE, RESUME, RESET };
 
-    Board board_;
-    MoveValidator validator_;
-    Timer timer_;
+        Kind kind = Kind::WAKE;
+        uint32_t piece_id = 0;
+        Position target{};
+        GameSettings settings{};
+        // Signalled once the command has been applied; null for wake-ups.
+        Completion* completion = nullptr;
+    };
 
-    GameState state_;
-    std::function<void(GameState)> state_change_callback_;
+    void wake();
+    // Queues the command and returns its result once it has been applied.
+    bool execute(Command command);
+    // Applies queued commands until the queue is empty, unless another
+    // thread is already doing so. True if this thread drained.
+    bool drain();
+    bool apply(const Command& command);
+
+    void doApplySettings(const GameSettings& settings);
+    bool doStart();
+    bool doPause();
+    bool doResume();
+    bool doReset();
+    bool doMakeMove(uint32_t piece_id, Position target);
+    void setState(GameState state);
+
+    // Releases pieces whose cooldown has expired by `now`, refreshes the
+    // remaining ticks of the rest and arms the clock for the next expiry.
+    // Cooldowns set on the board directly start counting from `now`.
+    void syncCooldowns(ClockSource::Time now);
+    void publish();
+    Board rebuildBoard(const BoardSnapshot& snapshot, ClockSource::Time now) const;
+    void updateGameState();
+    int cooldownFor(PlayerColor color) const;
 
+    // Owned by the thread currently draining the queue.
+    Board board_;
+    CooldownSchedule cooldowns_;
+    GameState state_;
     int white_cooldown_;
     int black_cooldown_;
     bool against_ai_;
+    uint64_t sequence_;
+
+    MoveValidator validator_;
+    std::unique_ptr<ClockSource> clock_;
+    std::function<void(GameState)> state_change_callback_;
+
+    MpscQueue<Command> commands_;
+    // Commands pushed and not yet applied.
+    std::atomic<int64_t> queued_;
+    std::atomic<bool> draining_;
+    std::atomic<std::thread::id> drainer_;
+    // Callers asleep until their command completes; the drainer only takes
+    // the mutex to wake them when there are any.
+    std::atomic<int> sleepers_;
+    std::mutex completion_mutex_;
+    std::condition_variable completed_;
+
+    SnapshotPublisher<BoardSnapshot> snapshots_;
+    // Tells this game's boards apart in the per-thread board cache.
+    const uint64_t cache_id_;
 };
@@ -1,4 +1,6 @@
 #include "move_validator.h"
+#include "attack_tables.h"
+#include "sliding_attacks.h"
 #include <cmath>
 #include <algorithm>
 #include <vector>
@@ -7,12 +9,12 @@ MoveValidator::MoveValidator() {
 }
 
 bool MoveValidator::isValidMove(const Board& board, uint32_t piece_id, Position target) const {
-    auto piece_opt = board.getPieceById(piece_id);
+    const Piece* piece_opt = board.findPiece(piece_id);
     if (!piece_opt) {
         return false;
     }
 
-    const Piece& piece = piece_opt.value();
+    const Piece& piece = *piece_opt;
 
     if (piece.captured) {
         return false;
@@ -51,21 +53,150 @@ bool MoveValidator::isValidMove(const Board& board, uint32_t piece_id, Position
 std::vector<Position> MoveValidator::getValidMoves(const Board& board, uint32_t piece_id) const {
     std::vector<Position> valid_moves;
 
-    auto piece_opt = board.getPieceById(piece_id);
-    if (!piece_opt || piece_opt->captured || piece_opt->cooldown_ticks_remaining > 0) {
+    const Piece* piece_opt = board.findPiece(piece_id);
+    if (!piece_opt) {
         return valid_moves;
     }
 
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            Position target = {row, col};
-            if (isValidMove(board, piece_id, target)) {
-                valid_moves.push_back(target);
+    Bitboard targets = getMoveTargets(board, *piece_opt);
+    valid_moves.reserve(popCount(targets));
+    while (targets) {
+        valid_moves.push_back(squarePosition(popLowestSquare(targets)));
+    }
+
+    return valid_moves;
+}
+
+Bitboard MoveValidator::getMoveTargets(const Board& board, const Piece& piece) const {
+    if (piece.captured || piece.cooldown_ticks_remaining > 0) {
+        return 0;
+    }
+
+    Bitboard targets = 0;
+    switch (piece.type) {
+        case PieceType::PAWN:
+            return pawnTargets(board, piece);
+        case PieceType::KING:
+            targets = getAttacks(board, piece) | castlingTargets(board, piece);
+            break;
+        default:
+            targets = getAttacks(board, piece);
+            break;
+    }
+
+    return targets & ~board.colorOccupancy(piece.color);
+}
+
+Bitboard MoveValidator::getAttacks(const Board& board, const Piece& piece) const {
+    int square = squareIndex(piece.position);
+    switch (piece.type) {
+        case PieceType::PAWN:
+            return attacks::pawnAttacks(piece.color, square);
+        case PieceType::KNIGHT:
+            return attacks::knightAttacks(square);
+        case PieceType::BISHOP:
+            return attacks::bishopAttacks(square, board.occupancy());
+        case PieceType::ROOK:
+            return attacks::rookAttacks(square, board.occupancy());
+        case PieceType::QUEEN:
+            return attacks::queenAttacks(square, board.occupancy());
+        case PieceType::KING:
+            return attacks::kingAttacks(square);
+    }
+    return 0;
+}
+
+void MoveValidator::generatePieceMoves(const Board& board, const Piece& piece, std::vector<Move>& moves) const {
+    Bitboard targets = getMoveTargets(board, piece);
+    while (targets) {
+        Move move;
+        move.piece_id = piece.id;
+        move.from = piece.position;
+        move.to = squarePosition(popLowestSquare(targets));
+        move.timestamp = 0;
+        moves.push_back(move);
+    }
+}
+
+void MoveValidator::generateMoves(const Board& board, PlayerColor color, std::vector<Move>& moves) const {
+    Bitboard own = board.colorOccupancy(color);
+    while (own) {
+        const Piece* piece = board.findPiece(board.pieceIdAt(popLowestSquare(own)));
+        generatePieceMoves(board, *piece, moves);
+    }
+}
+
+void MoveValidator::generateAllMoves(const Board& board, std::vector<Move>& moves) const {
+    generateMoves(board, PlayerColor::WHITE, moves);
+    generateMoves(board, PlayerColor::BLACK, moves);
+}
+
+Bitboard MoveValidator::pawnTargets(const Board& board, const Piece& piece) const {
+    int direction = (piece.color == PlayerColor::WHITE) ? 1 : -1;
+    int start_row = (piece.color == PlayerColor::WHITE) ? 1 : 6;
+    int forward_one = piece.position.row + direction;
+    int col = piece.position.col;
+
+    if (forward_one < 0 || forward_one > 7) {
+        return 0;
+    }
+
+    Bitboard occupied = board.occupancy();
+    Bitboard targets = 0;
+
+    Bitboard one_step = squareBit(squareIndex(forward_one, col));
+    if (!(occupied & one_step)) {
+        targets |= one_step;
+
+        if (piece.position.row == start_row && !piece.moved) {
+            Bitboard two_step = squareBit(squareIndex(forward_one + direction, col));
+            if (!(occupied & two_step)) {
+                targets |= two_step;
             }
         }
     }
 
-    return valid_moves;
+    targets |= attacks::pawnAttacks(piece.color, squareIndex(piece.position)) &
+               board.colorOccupancy(opponentColor(piece.color));
+
+    return targets;
+}
+
+Bitboard MoveValidator::castlingTargets(const Board& board, const Piece& piece) const {
+    if (piece.moved) {
+        return 0;
+    }
+
+    Bitboard occupied = board.occupancy();
+    Bitboard targets = 0;
+    int row = piece.position.row;
+
+    for (int step = -1; step <= 1; step += 2) {
+        int target_col = piece.position.col + 2 * step;
+        int rook_col = step > 0 ? 7 : 0;
+        if (!isOnBoard(row, target_col)) {
+            continue;
+        }
+
+        const Piece* rook = board.findPieceAt({row, rook_col});
+        if (!rook || rook->type != PieceType::ROOK || rook->color != piece.color || rook->moved) {
+            continue;
+        }
+
+        bool path_clear = true;
+        for (int col = piece.position.col + step; col != rook_col; col += step) {
+            if (occupied & squareBit(squareIndex(row, col))) {
+                path_clear = false;
+                break;
+            }
+        }
+
+        if (path_clear) {
+            targets |= squareBit(squareIndex(row, target_col));
+        }
+    }
+
+    return targets;
 }
 
 bool MoveValidator::isValidPawnMove(const Board& board, const Piece& piece, Position target) const {
@@ -73,8 +204,10 @@ bool MoveValidator::isValidPawnMove(const Board& board, const Piece& piece, Posi
     int forward_one = piece.position.row + direction;
     int start_row = (piece.color == PlayerColor::WHITE) ? 1 : 6;
 
+    Bitboard occupied = board.occupancy();
+
     if (target.col == piece.position.col && target.row == forward_one) {
-        return !board.getPieceAt(target).has_value();
+        return !(occupied & squareBit(target));
     }
 
     if (piece.position.row == start_row &&
@@ -82,65 +215,45 @@ bool MoveValidator::isValidPawnMove(const Board& board, const Piece& piece, Posi
         target.row == piece.position.row + 2 * direction) {
 
         Position intermediate = {piece.position.row + direction, piece.position.col};
-        return !board.getPieceAt(intermediate).has_value() &&
-               !board.getPieceAt(target).has_value() &&
+        return !(occupied & squareBit(intermediate)) &&
+               !(occupied & squareBit(target)) &&
                !piece.moved;
     }
 
-    if (target.row == forward_one &&
-        (target.col == piece.position.col - 1 || target.col == piece.position.col + 1)) {
-
-        auto target_piece = board.getPieceAt(target);
-        return target_piece && target_piece->color != piece.color;
+    if (attacks::pawnAttacks(piece.color, squareIndex(piece.position)) & squareBit(target)) {
+        return board.colorOccupancy(opponentColor(piece.color)) & squareBit(target);
     }
 
     return false;
 }
 
 bool MoveValidator::isValidKnightMove(const Board& board, const Piece& piece, Position target) const {
-    int row_diff = std::abs(target.row - piece.position.row);
-    int col_diff = std::abs(target.col - piece.position.col);
-
-    return (row_diff == 2 && col_diff == 1) || (row_diff == 1 && col_diff == 2);
+    return attacks::knightAttacks(squareIndex(piece.position)) & squareBit(target);
 }
 
 bool MoveValidator::isValidBishopMove(const Board& board, const Piece& piece, Position target) const {
-    int row_diff = std::abs(target.row - piece.position.row);
-    int col_diff = std::abs(target.col - piece.position.col);
-
-    if (row_diff != col_diff) {
-        return false;
-    }
-
-    return isPathClear(board, piece.position, target);
+    return attacks::bishopAttacks(squareIndex(piece.position), board.occupancy()) & squareBit(target);
 }
 
 bool MoveValidator::isValidRookMove(const Board& board, const Piece& piece, Position target) const {
-    if (piece.position.row != target.row && piece.position.col != target.col) {
-        return false;
-    }
-
-    return isPathClear(board, piece.position, target);
+    return attacks::rookAttacks(squareIndex(piece.position), board.occupancy()) & squareBit(target);
 }
 
 bool MoveValidator::isValidQueenMove(const Board& board, const Piece& piece, Position target) const {
-    return isValidRookMove(board, piece, target) || isValidBishopMove(board, piece, target);
+    return attacks::queenAttacks(squareIndex(piece.position), board.occupancy()) & squareBit(target);
 }
 
 bool MoveValidator::isValidKingMove(const Board& board, const Piece& piece, Position target) const {
-    int row_diff = std::abs(target.row - piece.position.row);
-    int col_diff = std::abs(target.col - piece.position.col);
-
-    if (row_diff <= 1 && col_diff <= 1) {
+    if (attacks::kingAttacks(squareIndex(piece.position)) & squareBit(target)) {
         return true;
     }
 
-    if (!piece.moved && row_diff == 0 && col_diff == 2) {
+    if (!piece.moved && target.row == piece.position.row && std::abs(target.col - piece.position.col) == 2) {
         bool is_kingside = target.col > piece.position.col;
         int rook_col = is_kingside ? 7 : 0;
 
         Position rook_pos = {piece.position.row, rook_col};
-        auto rook_opt = board.getPieceAt(rook_pos);
+        const Piece* rook_opt = board.findPieceAt(rook_pos);
 
         if (!rook_opt || rook_opt->type != PieceType::ROOK ||
             rook_opt->color != piece.color || rook_opt->moved) {
@@ -150,7 +263,7 @@ bool MoveValidator::isValidKingMove(const Board& board, const Piece& piece, Posi
         int step = is_kingside ? 1 : -1;
         for (int col = piece.position.col + step; col != rook_col; col += step) {
             Position pos = {piece.position.row, col};
-            if (board.getPieceAt(pos)) {
+            if (board.occupancy() & squareBit(pos)) {
                 return false;
             }
         }
@@ -161,29 +274,10 @@ bool MoveValidator::isValidKingMove(const Board& board, const Piece& piece, Posi
     return false;
 }
 
-bool MoveValidator::isPathClear(const Board& board, Position from, Position to) const {
-    int row_dir = 0;
-    if (from.row < to.row) row_dir = 1;
-    else if (from.row > to.row) row_dir = -1;
-
-    int col_dir = 0;
-    if (from.col < to.col) col_dir = 1;
-    else if (from.col > to.col) col_dir = -1;
-
-    Position current = {from.row + row_dir, from.col + col_dir};
-    while (current != to) {
-        if (board.getPieceAt(current).has_value()) {
-            return false;
-        }
-        current.row += row_dir;
-        current.col += col_dir;
-    }
-
-    return true;
-}
-
 bool MoveValidator::isTargetEmptyOrEnemy(const Board& board, const Piece& piece, Position target) const {
-    auto target_piece = board.getPieceAt(target);
+    if (!isOnBoard(target)) {
+        return false;
+    }
 
-    return !target_piece || target_piece->color != piece.color;
+    return !(board.colorOccupancy(piece.color) & squareBit(target));
 }
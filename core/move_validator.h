@@ -9,6 +9,19 @@ public:
     bool isValidMove(const Board& board, uint32_t piece_id, Position target) const;
     std::vector<Position> getValidMoves(const Board& board, uint32_t piece_id) const;
 
+    // Bulk generation straight from each piece's movement pattern. Produces
+    // exactly the moves isValidMove() accepts, including castling and the
+    // double pawn push; pieces that are captured or on cooldown yield nothing.
+    Bitboard getMoveTargets(const Board& board, const Piece& piece) const;
+    void generatePieceMoves(const Board& board, const Piece& piece, std::vector<Move>& moves) const;
+    void generateMoves(const Board& board, PlayerColor color, std::vector<Move>& moves) const;
+    void generateAllMoves(const Board& board, std::vector<Move>& moves) const;
+
+    // Squares the piece attacks (captures it could make), ignoring whose
+    // pieces stand there and ignoring cooldowns. Sliders use the magic/PEXT
+    // lookup from sliding_attacks.h.
+    Bitboard getAttacks(const Board& board, const Piece& piece) const;
+
 private:
     bool isValidPawnMove(const Board& board, const Piece& piece, Position target) const;
     bool isValidKnightMove(const Board& board, const Piece& piece, Position target) const;
@@ -17,6 +30,8 @@ private:
     bool isValidQueenMove(const Board& board, const Piece& piece, Position target) const;
     bool isValidKingMove(const Board& board, const Piece& piece, Position target) const;
 
-    bool isPathClear(const Board& board, Position from, Position to) const;
+    Bitboard pawnTargets(const Board& board, const Piece& piece) const;
+    Bitboard castlingTargets(const Board& board, const Piece& piece) const;
+
     bool isTargetEmptyOrEnemy(const Board& board, const Piece& piece, Position target) const;
 };
@@ -0,0 +1,69 @@
+#pragma once
+#include "bitboard.h"
+#include <array>
+
+// Material plus placement bonus for every (color, type, square), built at
+// compile time. Board keeps the per-color sum up to date on every
+// placement change, so a quiet move shifts the score by two lookups.
+namespace eval {
+
+inline constexpr int kPieceValues[kPieceTypeCount] = {100, 300, 320, 500, 900, 0};
+
+constexpr int centerBonus(int square) {
+    Position position = squarePosition(square);
+    int row_distance = position.row < 4 ? 3 - position.row : position.row - 4;
+    int col_distance = position.col < 4 ? 3 - position.col : position.col - 4;
+    return 12 - 4 * (row_distance + col_distance);
+}
+
+constexpr int pawnAdvance(PlayerColor color, int square) {
+    int row = squarePosition(square).row;
+    int progress = color == PlayerColor::WHITE ? row - 1 : 6 - row;
+    return progress * progress * 2;
+}
+
+constexpr int placementBonus(PlayerColor color, PieceType type, int square) {
+    switch (type) {
+        case PieceType::PAWN:
+            return pawnAdvance(color, square);
+        case PieceType::KNIGHT:
+        case PieceType::BISHOP:
+            return centerBonus(square);
+        default:
+            return 0;
+    }
+}
+
+using SquareScores = std::array<int, kSquareCount>;
+using PieceSquareTable = std::array<std::array<SquareScores, kPieceTypeCount>, kColorCount>;
+
+constexpr PieceSquareTable makePieceSquareTable() {
+    PieceSquareTable table{};
+    for (int color = 0; color < kColorCount; color++) {
+        for (int type = 0; type < kPieceTypeCount; type++) {
+            for (int square = 0; square < kSquareCount; square++) {
+                table[color][type][square] = kPieceValues[type] +
+                        placementBonus(static_cast<PlayerColor>(color), static_cast<PieceType>(type), square);
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr PieceSquareTable kPieceSquare = makePieceSquareTable();
+
+constexpr int pieceSquare(PlayerColor color, PieceType type, int square) {
+    return kPieceSquare[colorIndex(color)][typeIndex(type)][square];
+}
+
+static_assert(pieceSquare(PlayerColor::WHITE, PieceType::KNIGHT, squareIndex(3, 3)) == 312,
+              "knight on d4 is worth its material plus the full centre bonus");
+static_assert(pieceSquare(PlayerColor::BLACK, PieceType::KNIGHT, squareIndex(0, 0)) == 288,
+              "knight in the corner loses the centre bonus");
+static_assert(pieceSquare(PlayerColor::WHITE, PieceType::PAWN, squareIndex(6, 0)) ==
+              pieceSquare(PlayerColor::BLACK, PieceType::PAWN, squareIndex(1, 0)),
+              "pawn tables mirror between colors");
+static_assert(pieceSquare(PlayerColor::WHITE, PieceType::KING, squareIndex(0, 4)) == 0,
+              "kings carry no score; losing one ends the game");
+
+}
@@ -0,0 +1,250 @@
+#include "sliding_attacks.h"
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SPEEDCHESS_X86_64 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(SPEEDCHESS_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define SPEEDCHESS_BMI2_TARGET __attribute__((target("bmi2")))
+#else
+#define SPEEDCHESS_BMI2_TARGET
+#endif
+
+namespace attacks {
+
+namespace {
+
+const int kRookDirections[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+const int kBishopDirections[4][2] = {{1, 1}, {1, -1}, {-1, 1}, {-1, -1}};
+
+// Reference ray walk, only used while building the tables.
+Bitboard rayAttacks(int square, Bitboard occupied, const int (&directions)[4][2]) {
+    Bitboard result = 0;
+    Position from = squarePosition(square);
+    for (const auto& direction : directions) {
+        int row = from.row + direction[0];
+        int col = from.col + direction[1];
+        while (isOnBoard(row, col)) {
+            Bitboard bit = squareBit(squareIndex(row, col));
+            result |= bit;
+            if (occupied & bit) {
+                break;
+            }
+            row += direction[0];
+            col += direction[1];
+        }
+    }
+    return result;
+}
+
+// Squares whose occupancy can change the attack set: the rays without the
+// board edge they run into.
+Bitboard relevantMask(int square, const int (&directions)[4][2]) {
+    Bitboard result = 0;
+    Position from = squarePosition(square);
+    for (const auto& direction : directions) {
+        int row = from.row + direction[0];
+        int col = from.col + direction[1];
+        while (isOnBoard(row + direction[0], col + direction[1])) {
+            result |= squareBit(squareIndex(row, col));
+            row += direction[0];
+            col += direction[1];
+        }
+    }
+    return result;
+}
+
+struct SquareMagic {
+    Bitboard mask;
+    Bitboard magic;
+    int shift;
+    const Bitboard* magic_attacks;
+    const Bitboard* pext_attacks;
+};
+
+struct SliderTable {
+    SquareMagic squares[kSquareCount];
+    std::vector<Bitboard> magic_storage;
+    std::vector<Bitboard> pext_storage;
+};
+
+uint64_t nextRandom(uint64_t& state) {
+    state ^= state >> 12;
+    state ^= state << 25;
+    state ^= state >> 27;
+    return state * 2685821657736338717ULL;
+}
+
+uint64_t sparseRandom(uint64_t& state) {
+    return nextRandom(state) & nextRandom(state) & nextRandom(state);
+}
+
+// Per-rank PRNG seeds known to reach a collision-free magic after only a few
+// candidates with this generator, which keeps startup cheap even in debug
+// builds. Any seed works; these are just fast.
+const uint64_t kRankSeeds[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+
+// Finds a collision-free magic per square from fixed seeds, so the tables are
+// identical on every run.
+void buildTable(SliderTable& table, const int (&directions)[4][2]) {
+    size_t total = 0;
+    for (int square = 0; square < kSquareCount; square++) {
+        total += size_t{1} << popCount(relevantMask(square, directions));
+    }
+    table.magic_storage.assign(total, 0);
+    table.pext_storage.assign(total, 0);
+
+    size_t offset = 0;
+    std::vector<Bitboard> occupancies;
+    std::vector<Bitboard> references;
+    std::vector<int> epoch;
+
+    for (int square = 0; square < kSquareCount; square++) {
+        SquareMagic& entry = table.squares[square];
+        entry.mask = relevantMask(square, directions);
+        int bits = popCount(entry.mask);
+        size_t size = size_t{1} << bits;
+        entry.shift = 64 - bits;
+
+        Bitboard* magic_attacks = table.magic_storage.data() + offset;
+        Bitboard* pext_attacks = table.pext_storage.data() + offset;
+        entry.magic_attacks = magic_attacks;
+        entry.pext_attacks = pext_attacks;
+        offset += size;
+
+        // Carry-rippler enumeration visits subsets in ascending order, which is
+        // exactly the order of their PEXT-compressed indices.
+        occupancies.clear();
+        references.clear();
+        Bitboard subset = 0;
+        do {
+            occupancies.push_back(subset);
+            references.push_back(rayAttacks(square, subset, directions));
+            pext_attacks[occupancies.size() - 1] = references.back();
+            subset = (subset - entry.mask) & entry.mask;
+        } while (subset);
+
+        uint64_t state = kRankSeeds[square / 8];
+        epoch.assign(size, 0);
+        for (int attempt = 1;; attempt++) {
+            Bitboard magic = sparseRandom(state);
+            if (popCount((entry.mask * magic) >> 56) < 6) {
+                continue;
+            }
+
+            bool collision = false;
+            for (size_t i = 0; i < occupancies.size() && !collision; i++) {
+                size_t index = static_cast<size_t>((occupancies[i] * magic) >> entry.shift);
+                if (epoch[index] < attempt) {
+                    epoch[index] = attempt;
+                    magic_attacks[index] = references[i];
+                } else if (magic_attacks[index] != references[i]) {
+                    collision = true;
+                }
+            }
+
+            if (!collision) {
+                entry.magic = magic;
+                break;
+            }
+        }
+    }
+}
+
+bool detectPext() {
+#if defined(SPEEDCHESS_X86_64) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("bmi2");
+#elif defined(SPEEDCHESS_X86_64) && defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+struct SliderTables {
+    SliderTable rook;
+    SliderTable bishop;
+    bool pext_supported;
+    bool use_pext;
+
+    SliderTables() {
+        buildTable(rook, kRookDirections);
+        buildTable(bishop, kBishopDirections);
+        pext_supported = detectPext();
+        use_pext = pext_supported;
+    }
+};
+
+SliderTables g_tables;
+
+inline Bitboard magicLookup(const SquareMagic& entry, Bitboard occupied) {
+    return entry.magic_attacks[((occupied & entry.mask) * entry.magic) >> entry.shift];
+}
+
+#ifdef SPEEDCHESS_X86_64
+SPEEDCHESS_BMI2_TARGET inline Bitboard pextLookup(const SquareMagic& entry, Bitboard occupied) {
+    return entry.pext_attacks[_pext_u64(occupied, entry.mask)];
+}
+#else
+inline Bitboard pextLookup(const SquareMagic& entry, Bitboard occupied) {
+    return magicLookup(entry, occupied);
+}
+#endif
+
+}
+
+Bitboard rookAttacksMagic(int square, Bitboard occupied) {
+    return magicLookup(g_tables.rook.squares[square], occupied);
+}
+
+Bitboard bishopAttacksMagic(int square, Bitboard occupied) {
+    return magicLookup(g_tables.bishop.squares[square], occupied);
+}
+
+SPEEDCHESS_BMI2_TARGET Bitboard rookAttacksPext(int square, Bitboard occupied) {
+    return pextLookup(g_tables.rook.squares[square], occupied);
+}
+
+SPEEDCHESS_BMI2_TARGET Bitboard bishopAttacksPext(int square, Bitboard occupied) {
+    return pextLookup(g_tables.bishop.squares[square], occupied);
+}
+
+Bitboard rookAttacks(int square, Bitboard occupied) {
+    if (g_tables.use_pext) {
+        return rookAttacksPext(square, occupied);
+    }
+    return rookAttacksMagic(square, occupied);
+}
+
+Bitboard bishopAttacks(int square, Bitboard occupied) {
+    if (g_tables.use_pext) {
+        return bishopAttacksPext(square, occupied);
+    }
+    return bishopAttacksMagic(square, occupied);
+}
+
+bool pextSupported() {
+    return g_tables.pext_supported;
+}
+
+SliderBackend sliderBackend() {
+    return g_tables.use_pext ? SliderBackend::PEXT : SliderBackend::MAGIC;
+}
+
+bool setSliderBackend(SliderBackend backend) {
+    if (backend == SliderBackend::PEXT && !g_tables.pext_supported) {
+        return false;
+    }
+    g_tables.use_pext = backend == SliderBackend::PEXT;
+    return true;
+}
+
+}
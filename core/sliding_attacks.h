@@ -0,0 +1,35 @@
+#pragma once
+#include "bitboard.h"
+
+// Rook/bishop/queen attack sets in one or two table lookups. Two index
+// schemes share the same precomputed attack sets: classic magic
+// multiplication, and BMI2 PEXT where the CPU has it. The PEXT variant is
+// picked at startup when supported; both stay callable for testing.
+namespace attacks {
+
+enum class SliderBackend {
+    MAGIC,
+    PEXT
+};
+
+Bitboard rookAttacks(int square, Bitboard occupied);
+Bitboard bishopAttacks(int square, Bitboard occupied);
+
+inline Bitboard queenAttacks(int square, Bitboard occupied) {
+    return rookAttacks(square, occupied) | bishopAttacks(square, occupied);
+}
+
+Bitboard rookAttacksMagic(int square, Bitboard occupied);
+Bitboard bishopAttacksMagic(int square, Bitboard occupied);
+
+// Only valid when pextSupported() is true.
+Bitboard rookAttacksPext(int square, Bitboard occupied);
+Bitboard bishopAttacksPext(int square, Bitboard occupied);
+
+bool pextSupported();
+SliderBackend sliderBackend();
+// Forces a backend (e.g. MAGIC on CPUs with slow microcoded PEXT).
+// Returns false and keeps the current backend if PEXT is not supported.
+bool setSliderBackend(SliderBackend backend);
+
+}
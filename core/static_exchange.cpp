@@ -0,0 +1,107 @@
+#include "static_exchange.h"
+#include "piece_square_tables.h"
+#include "sliding_attacks.h"
+#include <algorithm>
+
+namespace eval {
+
+namespace {
+
+int exchangeValue(PieceType type) {
+    return type == PieceType::KING ? kExchangeKingValue : kPieceValues[typeIndex(type)];
+}
+
+// Least valuable piece of `attackers`; returns its square or -1.
+int leastValuable(const Board& board, Bitboard attackers, PieceType& type) {
+    for (int index = 0; index < kPieceTypeCount; index++) {
+        Bitboard candidates = attackers & board.typeOccupancy(static_cast<PieceType>(index));
+        if (candidates) {
+            type = static_cast<PieceType>(index);
+            return lowestSquare(candidates);
+        }
+    }
+    return -1;
+}
+
+// Material won by the first capture alone, promotion included; `on_square`
+// becomes the piece left standing on the target.
+int firstGain(const Board& board, const Piece& mover, Position to, PieceType& on_square) {
+    const Piece* victim = board.findPieceAt(to);
+    int gain = victim ? exchangeValue(victim->type) : 0;
+    on_square = mover.type;
+    if (mover.type == PieceType::PAWN && (to.row == 0 || to.row == 7)) {
+        on_square = PieceType::QUEEN;
+        gain += exchangeValue(PieceType::QUEEN) - exchangeValue(PieceType::PAWN);
+    }
+    return gain;
+}
+
+// Swap list of the exchange: gain[d] is the balance for the side making
+// capture d if the sequence stopped right after it.
+int resolveExchange(const Board& board, const Piece& mover, int to_square) {
+    int gain[Board::kMaxPieces + 1];
+    int depth = 0;
+
+    PieceType on_square;
+    gain[0] = firstGain(board, mover, squarePosition(to_square), on_square);
+
+    Bitboard diagonal = board.typeOccupancy(PieceType::BISHOP) | board.typeOccupancy(PieceType::QUEEN);
+    Bitboard straight = board.typeOccupancy(PieceType::ROOK) | board.typeOccupancy(PieceType::QUEEN);
+    Bitboard ready = ~board.coolingPieces();
+    Bitboard occupied = board.occupancy() & ~squareBit(mover.position);
+    Bitboard attackers = board.attackersTo(to_square, occupied) & ready;
+
+    PlayerColor side = opponentColor(mover.color);
+    while (true) {
+        depth++;
+        gain[depth] = exchangeValue(on_square) - gain[depth - 1];
+        // Neither continuing nor stopping can change the sign any more.
+        if (std::max(-gain[depth - 1], gain[depth]) < 0) {
+            break;
+        }
+
+        int from = leastValuable(board, attackers & board.colorOccupancy(side), on_square);
+        if (from < 0) {
+            break;
+        }
+        occupied &= ~squareBit(from);
+        attackers |= (attacks::bishopAttacks(to_square, occupied) & diagonal) |
+                     (attacks::rookAttacks(to_square, occupied) & straight);
+        attackers &= occupied & ready;
+        side = opponentColor(side);
+    }
+
+    while (--depth) {
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+    }
+    return gain[0];
+}
+
+}
+
+int staticExchange(const Board& board, uint32_t piece_id, Position to) {
+    const Piece* mover = board.findPiece(piece_id);
+    if (!mover || mover->captured) {
+        return 0;
+    }
+    return resolveExchange(board, *mover, squareIndex(to));
+}
+
+bool exchangeAtLeast(const Board& board, uint32_t piece_id, Position to, int threshold) {
+    const Piece* mover = board.findPiece(piece_id);
+    if (!mover || mover->captured) {
+        return threshold <= 0;
+    }
+    PieceType on_square;
+    int gain = firstGain(board, *mover, to, on_square);
+    // Even an unanswered capture falls short, or even losing the mover clears it.
+    if (gain < threshold) {
+        return false;
+    }
+    if (gain - exchangeValue(on_square) >= threshold) {
+        return true;
+    }
+    return resolveExchange(board, *mover, squareIndex(to)) >= threshold;
+}
+
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include "board.h"
+
+// Static exchange evaluation: the material outcome, in centipawns, of moving
+// `piece_id` to `to` and letting both sides recapture on that square with
+// their least valuable attacker for as long as it pays. Only pieces off
+// cooldown take part, since a cooling piece cannot recapture in time; the
+// moving piece is assumed ready. A quiet move scores 0 or the loss of the
+// mover if the square is covered. Sliders uncovered behind earlier
+// captures (x-rays) join the exchange.
+namespace eval {
+
+// Kings are worth more than everything else combined: losing one ends the game.
+inline constexpr int kExchangeKingValue = 20000;
+
+int staticExchange(const Board& board, uint32_t piece_id, Position to);
+
+// True when staticExchange(board, piece_id, to) >= threshold, stopping as
+// soon as the outcome is known.
+bool exchangeAtLeast(const Board& board, uint32_t piece_id, Position to, int threshold);
+
+}
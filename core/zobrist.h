@@ -0,0 +1,84 @@
+#pragma once
+#include "bitboard.h"
+#include <cstdint>
+
+// Zobrist keys for the racing-chess position. The board hash covers piece
+// placement, castling rights (an unmoved king or rook on its square) and a
+// two-bucket cooldown state (ready / cooling down) per occupied square, so
+// that it stays stable while cooldowns tick down. That is not enough for
+// search, where how soon a piece is back decides races: the search key adds
+// `cooling_interval`, the number of intervals each piece still waits.
+namespace zobrist {
+
+// Cooldowns further out than this many search intervals share a key.
+constexpr int kCoolingBuckets = 16;
+
+struct Keys {
+    uint64_t piece[kColorCount][kPieceTypeCount][kSquareCount];
+    uint64_t unmoved[kSquareCount];
+    uint64_t cooling[kSquareCount];
+    // Search-only keys: the side about to act, and whether the cooldown
+    // interval has already advanced for this pair of plies.
+    uint64_t side;
+    uint64_t interval;
+    // Indexed by intervals until ready, minus one.
+    uint64_t cooling_interval[kCoolingBuckets][kSquareCount];
+};
+
+constexpr uint64_t splitMix64(uint64_t& state) {
+    state += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+constexpr Keys makeKeys() {
+    Keys keys{};
+    uint64_t state = 0x5241434943484553ULL;
+
+    for (int color = 0; color < kColorCount; color++) {
+        for (int type = 0; type < kPieceTypeCount; type++) {
+            for (int square = 0; square < kSquareCount; square++) {
+                keys.piece[color][type][square] = splitMix64(state);
+            }
+        }
+    }
+    for (int square = 0; square < kSquareCount; square++) {
+        keys.unmoved[square] = splitMix64(state);
+    }
+    for (int square = 0; square < kSquareCount; square++) {
+        keys.cooling[square] = splitMix64(state);
+    }
+    keys.side = splitMix64(state);
+    keys.interval = splitMix64(state);
+    for (int bucket = 0; bucket < kCoolingBuckets; bucket++) {
+        for (int square = 0; square < kSquareCount; square++) {
+            keys.cooling_interval[bucket][square] = splitMix64(state);
+        }
+    }
+
+    return keys;
+}
+
+inline constexpr Keys kKeys = makeKeys();
+
+constexpr bool hasCastlingRight(const Piece& piece) {
+    return !piece.moved && (piece.type == PieceType::KING || piece.type == PieceType::ROOK);
+}
+
+constexpr uint64_t coolingKey(const Piece& piece) {
+    return piece.cooldown_ticks_remaining > 0 ? kKeys.cooling[squareIndex(piece.position)] : 0;
+}
+
+// Full contribution of one piece standing on its square.
+constexpr uint64_t pieceKey(const Piece& piece) {
+    int square = squareIndex(piece.position);
+    uint64_t key = kKeys.piece[colorIndex(piece.color)][typeIndex(piece.type)][square];
+    if (hasCastlingRight(piece)) {
+        key ^= kKeys.unmoved[square];
+    }
+    return key ^ coolingKey(piece);
+}
+
+}
@@ -40,6 +40,21 @@ int main() {
             case 4: settings.ai_difficulty = AIDifficulty::EXPERT; break;
             default: settings.ai_difficulty = AIDifficulty::MEDIUM; break;
         }
+
+        std::cout << "\nSelect AI engine:" << std::endl;
+        std::cout << "1. Default for difficulty" << std::endl;
+        std::cout << "2. Alpha-beta search" << std::endl;
+        std::cout << "3. Monte Carlo tree search" << std::endl;
+        std::cout << "Your choice (1-3): ";
+
+        int engine;
+        std::cin >> engine;
+
+        switch (engine) {
+            case 2: settings.ai_engine = AIEngine::ALPHA_BETA; break;
+            case 3: settings.ai_engine = AIEngine::MCTS; break;
+            default: break;
+        }
     }
 
     double white_cooldown_seconds;
@@ -79,4 +79,28 @@ TEST_F(AIPlayerTest, AIEvaluatesPositionsCorrectly) {
 
     
     
-}
\ No newline at end of file
+}
+
+TEST_F(AIPlayerTest, AIRespectsDeadline) {
+    AIPlayer expert_ai(AIDifficulty::EXPERT, PlayerColor::BLACK);
+    auto start = SearchLimits::Clock::now();
+    auto move = expert_ai.getBestMove(*game, start + std::chrono::milliseconds(20));
+    auto elapsed = SearchLimits::Clock::now() - start;
+
+    ASSERT_TRUE(move.has_value());
+    EXPECT_LT(elapsed, std::chrono::milliseconds(500));
+    EXPECT_GT(expert_ai.getLastSearch().nodes, 0u);
+    EXPECT_LE(expert_ai.getLastSearch().nodes, expert_ai.getSearchLimits().max_nodes);
+}
+
+TEST_F(AIPlayerTest, EasyResetsSearchLimits) {
+    AIPlayer player(AIDifficulty::EASY, PlayerColor::BLACK);
+    SearchLimits easy = player.getSearchLimits();
+
+    player.setDifficulty(AIDifficulty::HARD);
+    player.setDifficulty(AIDifficulty::EASY);
+    EXPECT_EQ(easy.max_depth, player.getSearchLimits().max_depth);
+    EXPECT_EQ(easy.tick_step, player.getSearchLimits().tick_step);
+    EXPECT_EQ(easy.max_nodes, player.getSearchLimits().max_nodes);
+    EXPECT_LT(easy.max_depth, 3);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include "../bot/ai_worker.h"
+#include "../utility/fen_parser.h"
+#include <thread>
+
+class AIWorkerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        game = std::make_unique<Game>([](GameState){});
+        GameSettings settings;
+        settings.white_cooldown_ticks = 10;
+        settings.black_cooldown_ticks = 10;
+        settings.tick_rate_ms = 100;
+        settings.fen_string = FENParser::getDefaultFEN();
+        game->applySettings(settings);
+        game->start();
+    }
+
+    std::optional<AIMoveResult> waitForResult(AIWorker& worker) {
+        auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (std::chrono::steady_clock::now() < give_up) {
+            if (auto result = worker.poll()) {
+                return result;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return std::nullopt;
+    }
+
+    void waitIdle(AIWorker& worker) {
+        auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (worker.busy() && std::chrono::steady_clock::now() < give_up) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    std::unique_ptr<Game> game;
+};
+
+TEST_F(AIWorkerTest, DeliversMoveThroughCompletionQueue) {
+    AIWorker worker(AIDifficulty::MEDIUM, PlayerColor::BLACK);
+    uint64_t id = worker.request(*game);
+
+    auto result = waitForResult(worker);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(id, result->request_id);
+    EXPECT_EQ(game->getBoard().hash(), result->position_hash);
+    ASSERT_TRUE(result->move.has_value());
+    EXPECT_TRUE(worker.stillApplies(*game, *result));
+    EXPECT_TRUE(worker.apply(*game, *result));
+}
+
+TEST_F(AIWorkerTest, CancelledSearchDeliversNothing) {
+    AIWorker worker(AIDifficulty::EXPERT, PlayerColor::BLACK);
+    worker.request(*game, SearchLimits::Clock::now() + std::chrono::seconds(30));
+    worker.cancel();
+
+    waitIdle(worker);
+    EXPECT_FALSE(worker.busy());
+    EXPECT_FALSE(worker.poll().has_value());
+}
+
+TEST_F(AIWorkerTest, NewerRequestSupersedesOlder) {
+    AIWorker worker(AIDifficulty::MEDIUM, PlayerColor::BLACK);
+    worker.request(*game, SearchLimits::Clock::now() + std::chrono::seconds(30));
+    uint64_t latest = worker.request(*game);
+
+    auto result = waitForResult(worker);
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(latest, result->request_id);
+    waitIdle(worker);
+    EXPECT_FALSE(worker.poll().has_value());
+}
+
+TEST_F(AIWorkerTest, DropsResultAfterBoardChanges) {
+    AIWorker worker(AIDifficulty::MEDIUM, PlayerColor::BLACK);
+    worker.request(*game);
+    auto result = waitForResult(worker);
+    ASSERT_TRUE(result.has_value());
+
+    auto pawn = game->getBoard().getPieceAt({1, 4});
+    ASSERT_TRUE(pawn.has_value());
+    ASSERT_TRUE(game->makeMove(pawn->id, {3, 4}));
+
+    EXPECT_FALSE(worker.stillApplies(*game, *result));
+    EXPECT_FALSE(worker.apply(*game, *result));
+}
+
+TEST_F(AIWorkerTest, PonderResultAnswersMatchingRequest) {
+    AIWorker worker(AIDifficulty::MEDIUM, PlayerColor::BLACK);
+    worker.ponder(*game, SearchLimits::Clock::now() + std::chrono::milliseconds(20));
+    EXPECT_FALSE(worker.busy());
+
+    auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (worker.pondering() && std::chrono::steady_clock::now() < give_up) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_FALSE(worker.pondering());
+
+    // Answered from the ponder result without another search.
+    uint64_t id = worker.request(*game);
+    auto result = worker.poll();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(id, result->request_id);
+    EXPECT_TRUE(worker.stillApplies(*game, *result));
+}
+
+TEST_F(AIWorkerTest, PonderProjectsPastOwnCooldowns) {
+    Game kings([](GameState){});
+    GameSettings settings;
+    settings.white_cooldown_ticks = 10;
+    settings.black_cooldown_ticks = 10;
+    settings.tick_rate_ms = 10;
+    settings.fen_string = "4k3/8/8/8/8/8/8/R3K3";
+    kings.applySettings(settings);
+    kings.start();
+
+    auto king = kings.getBoard().getPieceAt({7, 4});
+    ASSERT_TRUE(king.has_value());
+    uint32_t king_id = king->id;
+    ASSERT_TRUE(kings.makeMove(king_id, {7, 3}));
+
+    // Every black piece is cooling: the ponder targets the position after
+    // the king is ready again, which the game reaches on its own.
+    AIWorker worker(AIDifficulty::MEDIUM, PlayerColor::BLACK);
+    worker.ponder(kings, SearchLimits::Clock::now() + std::chrono::milliseconds(20));
+    auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while ((worker.pondering() || kings.getBoard().findPiece(king_id)->cooldown_ticks_remaining > 0) &&
+           std::chrono::steady_clock::now() < give_up) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    uint64_t id = worker.request(kings);
+    auto result = worker.poll();
+    ASSERT_TRUE(result.has_value());
+    EXPECT_EQ(id, result->request_id);
+    ASSERT_TRUE(result->move.has_value());
+    EXPECT_EQ(king_id, result->move->piece_id);
+    kings.pause();
+}
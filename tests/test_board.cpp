@@ -81,4 +81,182 @@ TEST_F(BoardTest, FENParsingAndGenerationWorks) {
     FENParser parser;
     std::string generated_fen = parser.boardToFEN(board);
     EXPECT_EQ("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR", generated_fen);
-}
\ No newline at end of file
+}
+
+TEST_F(BoardTest, BitboardsTrackPlacement) {
+    EXPECT_EQ(0x000000000000FFFFULL, board.colorOccupancy(PlayerColor::WHITE));
+    EXPECT_EQ(0xFFFF000000000000ULL, board.colorOccupancy(PlayerColor::BLACK));
+    EXPECT_EQ(squareBit(Position{0, 4}), board.pieces(PlayerColor::WHITE, PieceType::KING));
+
+    auto knight = board.getPieceAt({0, 6});
+    ASSERT_TRUE(knight.has_value());
+    EXPECT_EQ(knight->id, board.pieceIdAt(squareIndex(0, 6)));
+
+    board.movePiece(knight->id, {2, 5});
+    EXPECT_EQ(0u, board.pieceIdAt(squareIndex(0, 6)));
+    EXPECT_EQ(knight->id, board.pieceIdAt(squareIndex(2, 5)));
+    EXPECT_TRUE(board.pieces(PlayerColor::WHITE, PieceType::KNIGHT) & squareBit(Position{2, 5}));
+
+    auto black_pawn = board.getPieceAt({6, 4});
+    ASSERT_TRUE(black_pawn.has_value());
+    board.movePiece(knight->id, {6, 4});
+    EXPECT_TRUE(board.getPieceById(black_pawn->id)->captured);
+    EXPECT_EQ(15, popCount(board.colorOccupancy(PlayerColor::BLACK)));
+    EXPECT_FALSE(board.movePiece(knight->id, {0, 4}));
+}
+
+TEST_F(BoardTest, MakeUnmakeRestoresCastling) {
+    ASSERT_TRUE(board.setupFromFEN("r3k2r/8/8/8/8/8/8/R3K2R"));
+    std::string before = FENParser::boardToFEN(board);
+
+    auto king = board.getPieceAt({0, 4});
+    ASSERT_TRUE(king.has_value());
+
+    MoveUndo undo = board.makeMove(king->id, {0, 6}, 10);
+    auto rook = board.getPieceAt({0, 5});
+    ASSERT_TRUE(rook.has_value());
+    EXPECT_EQ(PieceType::ROOK, rook->type);
+    EXPECT_EQ(10, rook->cooldown_ticks_remaining);
+    EXPECT_EQ(10, board.getPieceById(king->id)->cooldown_ticks_remaining);
+
+    board.unmakeMove(undo);
+    EXPECT_EQ(before, FENParser::boardToFEN(board));
+    EXPECT_FALSE(board.getPieceById(king->id)->moved);
+    EXPECT_FALSE(board.getPieceAt({0, 7})->moved);
+    EXPECT_EQ(0, board.getPieceAt({0, 7})->cooldown_ticks_remaining);
+}
+
+TEST_F(BoardTest, MakeUnmakeRestoresCaptureAndPromotion) {
+    ASSERT_TRUE(board.setupFromFEN("1r2k3/P7/8/8/8/8/8/4K3"));
+    std::string before = FENParser::boardToFEN(board);
+
+    auto pawn = board.getPieceAt({6, 0});
+    auto rook = board.getPieceAt({7, 1});
+    ASSERT_TRUE(pawn.has_value());
+    ASSERT_TRUE(rook.has_value());
+
+    MoveUndo undo = board.makeMove(pawn->id, {7, 1}, 5);
+    EXPECT_EQ(PieceType::QUEEN, board.getPieceById(pawn->id)->type);
+    EXPECT_TRUE(board.getPieceById(rook->id)->captured);
+
+    board.unmakeMove(undo);
+    EXPECT_EQ(before, FENParser::boardToFEN(board));
+    EXPECT_EQ(PieceType::PAWN, board.getPieceById(pawn->id)->type);
+    EXPECT_FALSE(board.getPieceById(rook->id)->captured);
+    EXPECT_EQ(0, board.getPieceById(pawn->id)->cooldown_ticks_remaining);
+}
+
+TEST_F(BoardTest, HashTracksIncrementalUpdates) {
+    uint64_t start_hash = board.hash();
+    EXPECT_EQ(board.computeHash(), start_hash);
+
+    auto knight = board.getPieceAt({0, 6});
+    ASSERT_TRUE(knight.has_value());
+
+    board.movePiece(knight->id, {2, 5});
+    EXPECT_NE(start_hash, board.hash());
+    EXPECT_EQ(board.computeHash(), board.hash());
+
+    board.movePiece(knight->id, {0, 6});
+    EXPECT_EQ(start_hash, board.hash());
+
+    board.setPieceCooldown(knight->id, 2);
+    EXPECT_NE(start_hash, board.hash());
+    EXPECT_EQ(board.computeHash(), board.hash());
+    board.decrementCooldowns();
+    board.decrementCooldowns();
+    EXPECT_EQ(start_hash, board.hash());
+
+    auto rook = board.getPieceAt({0, 7});
+    ASSERT_TRUE(rook.has_value());
+    board.capturePieceAt({1, 7});
+    board.movePiece(rook->id, {1, 7});
+    board.movePiece(rook->id, {0, 7});
+    EXPECT_EQ(board.computeHash(), board.hash());
+
+    uint64_t before_move = board.hash();
+    auto pawn = board.getPieceAt({1, 6});
+    ASSERT_TRUE(pawn.has_value());
+    MoveUndo undo = board.makeMove(pawn->id, {3, 6}, 5);
+    EXPECT_EQ(board.computeHash(), board.hash());
+    board.unmakeMove(undo);
+    EXPECT_EQ(before_move, board.hash());
+    EXPECT_EQ(board.computeHash(), board.hash());
+}
+
+TEST_F(BoardTest, PieceSquareScoreTracksMakeUnmake) {
+    for (PlayerColor color : {PlayerColor::WHITE, PlayerColor::BLACK}) {
+        EXPECT_EQ(board.computePsqScore(color), board.psqScore(color));
+    }
+    EXPECT_EQ(board.psqScore(PlayerColor::WHITE), board.psqScore(PlayerColor::BLACK));
+
+    ASSERT_TRUE(board.setupFromFEN("1r2k3/P7/8/8/8/8/8/R3K2R"));
+    int white_before = board.psqScore(PlayerColor::WHITE);
+    int black_before = board.psqScore(PlayerColor::BLACK);
+
+    auto pawn = board.getPieceAt({6, 0});
+    auto king = board.getPieceAt({0, 4});
+    ASSERT_TRUE(pawn.has_value());
+    ASSERT_TRUE(king.has_value());
+
+    MoveUndo promotion = board.makeMove(pawn->id, {7, 1}, 5);
+    EXPECT_EQ(board.computePsqScore(PlayerColor::WHITE), board.psqScore(PlayerColor::WHITE));
+    EXPECT_EQ(board.computePsqScore(PlayerColor::BLACK), board.psqScore(PlayerColor::BLACK));
+    EXPECT_GT(board.psqScore(PlayerColor::WHITE), white_before);
+    EXPECT_LT(board.psqScore(PlayerColor::BLACK), black_before);
+
+    MoveUndo castle = board.makeMove(king->id, {0, 6}, 5);
+    EXPECT_EQ(board.computePsqScore(PlayerColor::WHITE), board.psqScore(PlayerColor::WHITE));
+
+    board.unmakeMove(castle);
+    board.unmakeMove(promotion);
+    EXPECT_EQ(white_before, board.psqScore(PlayerColor::WHITE));
+    EXPECT_EQ(black_before, board.psqScore(PlayerColor::BLACK));
+}
+
+TEST_F(BoardTest, CoolingPiecesTrackCooldowns) {
+    auto cooling = [this]() {
+        Bitboard expected = 0;
+        for (const Piece& piece : board.getAllPieces()) {
+            if (piece.cooldown_ticks_remaining > 0) {
+                expected |= squareBit(piece.position);
+            }
+        }
+        return expected;
+    };
+
+    auto knight = board.getPieceAt({0, 6});
+    ASSERT_TRUE(knight.has_value());
+    MoveUndo undo = board.makeMove(knight->id, {2, 5}, 3);
+    EXPECT_EQ(squareBit(Position{2, 5}), board.coolingPieces());
+
+    board.advanceCooldowns(2);
+    EXPECT_EQ(cooling(), board.coolingPieces());
+    board.advanceCooldowns(1);
+    EXPECT_EQ(Bitboard{0}, board.coolingPieces());
+    board.advanceCooldowns(-3);
+    EXPECT_EQ(cooling(), board.coolingPieces());
+
+    board.unmakeMove(undo);
+    EXPECT_EQ(Bitboard{0}, board.coolingPieces());
+}
+
+TEST_F(BoardTest, AttackMapsFollowBoardVersion) {
+    uint64_t version = board.version();
+    Bitboard white_attacks = board.attackedBy(PlayerColor::WHITE);
+    EXPECT_EQ(0x0000000000FF0000ULL, white_attacks & 0x0000000000FF0000ULL);
+    EXPECT_FALSE(board.isSquareAttacked({3, 4}, PlayerColor::WHITE));
+    EXPECT_EQ(version, board.version());
+
+    auto pawn = board.getPieceAt({1, 3});
+    board.movePiece(pawn->id, {2, 3});
+    EXPECT_GT(board.version(), version);
+    EXPECT_TRUE(board.isSquareAttacked({3, 4}, PlayerColor::WHITE));
+
+    ASSERT_TRUE(board.setupFromFEN("n3k3/8/8/8/8/8/8/4K3"));
+    auto knight = board.getPieceAt({7, 0});
+    EXPECT_TRUE(board.isSquareAttacked({5, 1}, PlayerColor::BLACK, true));
+    board.setPieceCooldown(knight->id, 5);
+    EXPECT_TRUE(board.isSquareAttacked({5, 1}, PlayerColor::BLACK));
+    EXPECT_FALSE(board.isSquareAttacked({5, 1}, PlayerColor::BLACK, true));
+}
@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include "../core/board_snapshot.h"
+
+using std::chrono::milliseconds;
+
+TEST(BoardSnapshotTest, MatchesTheBoardItWasTakenFrom) {
+    Board board;
+    board.setupStandardPosition();
+    const Piece* pawn = board.findPieceAt({1, 4});
+    ASSERT_NE(nullptr, pawn);
+    uint32_t pawn_id = pawn->id;
+    board.makeMove(pawn_id, {3, 4}, 5);
+
+    CooldownSchedule cooldowns;
+    cooldowns.start(pawn_id, milliseconds(500));
+    BoardSnapshot snapshot;
+    snapshot.capture(board, cooldowns, GameState::ACTIVE, 5, 7, 3);
+
+    EXPECT_EQ(3u, snapshot.sequence());
+    EXPECT_EQ(GameState::ACTIVE, snapshot.state());
+    EXPECT_EQ(7, snapshot.blackCooldown());
+    EXPECT_EQ(board.hash(), snapshot.hash());
+    EXPECT_EQ(board.occupancy(), snapshot.occupancy());
+    EXPECT_EQ(board.coolingPieces(), snapshot.coolingPieces());
+    EXPECT_EQ(32u, snapshot.pieces().size());
+
+    auto moved = snapshot.pieceAt({3, 4});
+    ASSERT_TRUE(moved.has_value());
+    EXPECT_EQ(pawn_id, moved->id);
+    EXPECT_TRUE(moved->moved);
+    EXPECT_EQ(5, moved->cooldown_ticks_remaining);
+    EXPECT_FALSE(snapshot.pieceAt({1, 4}).has_value());
+    EXPECT_EQ(milliseconds(200), snapshot.cooldownRemaining(pawn_id, milliseconds(300)));
+    EXPECT_EQ(milliseconds(0), snapshot.cooldownRemaining(pawn_id, milliseconds(600)));
+}
+
+TEST(BoardSnapshotTest, RestoresTheSameBoard) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("4k3/8/8/3p4/4P3/8/8/R3K3"));
+    const Piece* pawn = board.findPieceAt({3, 4});
+    ASSERT_NE(nullptr, pawn);
+    board.makeMove(pawn->id, {4, 3}, 2);
+
+    BoardSnapshot snapshot;
+    snapshot.capture(board, CooldownSchedule(), GameState::ACTIVE, 2, 2, 1);
+    Board restored;
+    snapshot.restore(restored);
+
+    EXPECT_EQ(board.hash(), restored.hash());
+    EXPECT_EQ(restored.computeHash(), restored.hash());
+    EXPECT_EQ(board.occupancy(), restored.occupancy());
+    EXPECT_EQ(board.coolingPieces(), restored.coolingPieces());
+    EXPECT_EQ(board.psqScore(PlayerColor::WHITE), restored.psqScore(PlayerColor::WHITE));
+    EXPECT_EQ(board.getAllPieces(true).size(), restored.getAllPieces(true).size());
+    for (const Piece& piece : board.getAllPieces(true)) {
+        const Piece* copy = restored.findPiece(piece.id);
+        ASSERT_NE(nullptr, copy);
+        EXPECT_EQ(piece.captured, copy->captured);
+        if (!piece.captured) {
+            EXPECT_EQ(piece.position, copy->position);
+        }
+    }
+}
+
+TEST(BoardSnapshotTest, HashAtCountsExpiredCooldownsAsReady) {
+    Board board;
+    board.setupStandardPosition();
+    uint32_t knight = board.findPieceAt({0, 6})->id;
+    board.makeMove(knight, {2, 5}, 3);
+
+    CooldownSchedule cooldowns;
+    cooldowns.start(knight, milliseconds(300));
+    BoardSnapshot snapshot;
+    snapshot.capture(board, cooldowns, GameState::ACTIVE, 3, 3, 1);
+    EXPECT_EQ(board.hash(), snapshot.hashAt(milliseconds(299)));
+
+    // Not yet released by the writer, but ready by the clock.
+    board.setPieceCooldown(knight, 0);
+    EXPECT_EQ(board.hash(), snapshot.hashAt(milliseconds(300)));
+    EXPECT_NE(snapshot.hash(), snapshot.hashAt(milliseconds(300)));
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "../core/cooldown_schedule.h"
+
+using std::chrono::milliseconds;
+
+TEST(CooldownScheduleTest, ReadyIsComputedFromTheClock) {
+    CooldownSchedule schedule;
+    EXPECT_TRUE(schedule.ready(3, milliseconds(0)));
+
+    schedule.start(3, milliseconds(250));
+    EXPECT_FALSE(schedule.ready(3, milliseconds(249)));
+    EXPECT_TRUE(schedule.ready(3, milliseconds(250)));
+    EXPECT_EQ(milliseconds(50), schedule.remaining(3, milliseconds(200)));
+    EXPECT_EQ(milliseconds(0), schedule.remaining(3, milliseconds(400)));
+    EXPECT_EQ(1u, schedule.pending());
+}
+
+TEST(CooldownScheduleTest, PopsExpiriesInOrder) {
+    CooldownSchedule schedule;
+    schedule.start(1, milliseconds(300));
+    schedule.start(2, milliseconds(100));
+    schedule.start(3, milliseconds(200));
+    EXPECT_EQ(milliseconds(100), schedule.nextExpiry());
+
+    std::vector<uint32_t> ready;
+    schedule.popExpired(milliseconds(50), ready);
+    EXPECT_TRUE(ready.empty());
+
+    schedule.popExpired(milliseconds(200), ready);
+    EXPECT_EQ((std::vector<uint32_t>{2, 3}), ready);
+    EXPECT_EQ(milliseconds(300), schedule.nextExpiry());
+    EXPECT_EQ(1u, schedule.pending());
+}
+
+TEST(CooldownScheduleTest, RestartedAndCancelledEntriesAreSkipped) {
+    CooldownSchedule schedule;
+    schedule.start(1, milliseconds(100));
+    schedule.start(1, milliseconds(500));
+    schedule.start(2, milliseconds(200));
+    schedule.cancel(2);
+    EXPECT_EQ(1u, schedule.pending());
+    EXPECT_EQ(milliseconds(500), schedule.nextExpiry());
+
+    std::vector<uint32_t> ready;
+    schedule.popExpired(milliseconds(400), ready);
+    EXPECT_TRUE(ready.empty());
+    schedule.popExpired(milliseconds(500), ready);
+    EXPECT_EQ((std::vector<uint32_t>{1}), ready);
+    EXPECT_EQ(CooldownSchedule::kNever, schedule.nextExpiry());
+    EXPECT_EQ(0u, schedule.pending());
+}
@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+#include "../core/game.h"
+#include "../utility/clock_source.h"
+#include "../utility/timer.h"
+#include <atomic>
+#include <ctime>
+#include <thread>
+
+class ManualClockGameTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        auto manual = std::make_unique<ManualClock>();
+        clock = manual.get();
+        game = std::make_unique<Game>([this](GameState state) { states.push_back(state); }, std::move(manual));
+
+        GameSettings settings{};
+        settings.white_cooldown_ticks = 30;
+        settings.black_cooldown_ticks = 20;
+        settings.tick_rate_ms = 100;
+        settings.fen_string = "standard";
+        game->applySettings(settings);
+        game->start();
+    }
+
+    ManualClock* clock = nullptr;
+    std::unique_ptr<Game> game;
+    std::vector<GameState> states;
+};
+
+TEST_F(ManualClockGameTest, TicksOnlyWhenAdvanced) {
+    auto knight = game->getBoard().getPieceAt({0, 6});
+    ASSERT_TRUE(knight.has_value());
+    ASSERT_TRUE(game->makeMove(knight->id, {2, 5}));
+    EXPECT_FALSE(game->makeMove(knight->id, {0, 6}));
+
+    EXPECT_EQ(29, clock->advance(29));
+    EXPECT_EQ(1, game->getBoard().findPiece(knight->id)->cooldown_ticks_remaining);
+    EXPECT_FALSE(game->makeMove(knight->id, {0, 6}));
+
+    clock->advance();
+    EXPECT_TRUE(game->makeMove(knight->id, {0, 6}));
+    EXPECT_EQ(30u, clock->ticks());
+    EXPECT_EQ(3000u, clock->elapsedMs());
+}
+
+TEST_F(ManualClockGameTest, PauseStopsTheClock) {
+    game->pause();
+    EXPECT_FALSE(clock->running());
+    EXPECT_EQ(0, clock->advance(10));
+
+    game->resume();
+    EXPECT_EQ(10, clock->advance(10));
+    EXPECT_EQ(GameState::ACTIVE, game->getState());
+}
+
+TEST_F(ManualClockGameTest, GameOverStopsTheClock) {
+    GameSettings settings{};
+    settings.white_cooldown_ticks = 30;
+    settings.black_cooldown_ticks = 20;
+    settings.tick_rate_ms = 100;
+    settings.fen_string = "4k3/8/8/8/8/8/8/4K2Q";
+    game->applySettings(settings);
+    game->start();
+    auto queen = game->getBoard().getPieceAt({0, 7});
+    ASSERT_TRUE(queen.has_value());
+    ASSERT_TRUE(game->makeMove(queen->id, {7, 7}));
+    clock->advance(30);
+    ASSERT_TRUE(game->makeMove(queen->id, {7, 4}));
+
+    EXPECT_EQ(GameState::WHITE_WIN, game->getState());
+    EXPECT_EQ(GameState::WHITE_WIN, states.back());
+    EXPECT_EQ(0, clock->advance(5));
+}
+
+TEST_F(ManualClockGameTest, IdleGameHasNothingToWakeFor) {
+    EXPECT_EQ(ClockSource::kNever, clock->wakeTime());
+
+    auto pawn = game->getBoard().getPieceAt({1, 4});
+    ASSERT_TRUE(pawn.has_value());
+    ASSERT_TRUE(game->makeMove(pawn->id, {3, 4}));
+    EXPECT_EQ(std::chrono::milliseconds(3000), clock->wakeTime());
+
+    clock->advance(30);
+    EXPECT_EQ(ClockSource::kNever, clock->wakeTime());
+    EXPECT_EQ(0, game->getBoard().findPiece(pawn->id)->cooldown_ticks_remaining);
+}
+
+TEST_F(ManualClockGameTest, ValidMovesFollowTheGame) {
+    auto knight = game->getBoard().getPieceAt({0, 6});
+    ASSERT_TRUE(knight.has_value());
+    EXPECT_EQ(2u, game->getValidMoves(knight->id).size());
+    EXPECT_EQ(game->getBoard().hash(), game->positionHash());
+
+    ASSERT_TRUE(game->makeMove(knight->id, {2, 5}));
+    EXPECT_TRUE(game->getValidMoves(knight->id).empty());
+
+    clock->advance(30);
+    EXPECT_EQ(5u, game->getValidMoves(knight->id).size());
+    EXPECT_EQ(game->getBoard().hash(), game->positionHash());
+}
+
+TEST_F(ManualClockGameTest, PublishesOncePerCommand) {
+    uint64_t sequence = game->snapshot()->sequence();
+    game->pause();
+    EXPECT_EQ(sequence + 1, game->snapshot()->sequence());
+    game->resume();
+    EXPECT_EQ(sequence + 2, game->snapshot()->sequence());
+
+    auto knight = game->getBoard().getPieceAt({0, 6});
+    ASSERT_TRUE(knight.has_value());
+    ASSERT_TRUE(game->makeMove(knight->id, {2, 5}));
+    EXPECT_EQ(sequence + 3, game->snapshot()->sequence());
+}
+
+TEST_F(ManualClockGameTest, CooldownsExpireBetweenTicks) {
+    using std::chrono::milliseconds;
+    auto pawn = game->getBoard().getPieceAt({1, 3});
+    ASSERT_TRUE(pawn.has_value());
+    clock->advanceBy(milliseconds(40));
+    ASSERT_TRUE(game->makeMove(pawn->id, {2, 3}));
+
+    clock->advanceBy(milliseconds(2990));
+    EXPECT_EQ(milliseconds(10), game->cooldownRemaining(pawn->id));
+    EXPECT_EQ(1, game->getBoard().findPiece(pawn->id)->cooldown_ticks_remaining);
+    EXPECT_FALSE(game->makeMove(pawn->id, {3, 3}));
+
+    clock->advanceBy(milliseconds(10));
+    EXPECT_EQ(milliseconds(0), game->cooldownRemaining(pawn->id));
+    EXPECT_TRUE(game->makeMove(pawn->id, {3, 3}));
+}
+
+// Real-time clocks: the shared scheduler by default, or a Timer thread.
+class RealTimeGameTest : public ::testing::TestWithParam<bool> {};
+
+TEST_P(RealTimeGameTest, WakesWhenACooldownExpires) {
+    Game game(nullptr, GetParam() ? std::make_unique<Timer>() : nullptr);
+    GameSettings settings{};
+    settings.white_cooldown_ticks = 2;
+    settings.black_cooldown_ticks = 2;
+    settings.tick_rate_ms = 10;
+    settings.fen_string = "standard";
+    game.applySettings(settings);
+    game.start();
+
+    auto knight = game.getBoard().getPieceAt({0, 1});
+    ASSERT_TRUE(knight.has_value());
+    ASSERT_TRUE(game.makeMove(knight->id, {2, 2}));
+    EXPECT_FALSE(game.makeMove(knight->id, {0, 1}));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_EQ(0, game.getBoard().coolingPieces());
+    EXPECT_TRUE(game.makeMove(knight->id, {0, 1}));
+}
+
+INSTANTIATE_TEST_SUITE_P(Clocks, RealTimeGameTest, ::testing::Values(false, true));
+
+TEST_F(ManualClockGameTest, RacingMovesApplyOnce) {
+    auto pawn = game->getBoard().getPieceAt({1, 4});
+    ASSERT_TRUE(pawn.has_value());
+
+    std::atomic<int> applied{0};
+    std::vector<std::thread> players;
+    for (int i = 0; i < 4; i++) {
+        players.emplace_back([&]() {
+            if (game->makeMove(pawn->id, {3, 4})) {
+                applied++;
+            }
+        });
+    }
+    for (auto& player : players) {
+        player.join();
+    }
+
+    EXPECT_EQ(1, applied.load());
+    EXPECT_EQ(pawn->id, game->getBoard().pieceIdAt(squareIndex({3, 4})));
+}
+
+TEST(ConcurrentGameTest, ReadersNeverSeeHalfAMove) {
+    Game game;
+    GameSettings settings{};
+    settings.white_cooldown_ticks = 1;
+    settings.black_cooldown_ticks = 1;
+    settings.tick_rate_ms = 1;
+    settings.fen_string = "standard";
+    game.applySettings(settings);
+    game.start();
+    uint32_t knight = game.getBoard().getPieceAt({0, 6})->id;
+
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 2; i++) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                Board board = game.getBoard();
+                const Piece* piece = board.findPiece(knight);
+                bool placed = piece && board.pieceIdAt(squareIndex(piece->position)) == knight;
+                if (!placed || board.getAllPieces().size() != 32 || board.hash() != board.computeHash()) {
+                    torn++;
+                }
+                game.getValidMoves(knight);
+            }
+        });
+    }
+
+    // The knight hops between g1 and f3 as fast as its cooldown allows.
+    Position squares[2] = {{2, 5}, {0, 6}};
+    auto give_up = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    int hop = 0;
+    while (hop < 20 && std::chrono::steady_clock::now() < give_up) {
+        if (game.makeMove(knight, squares[hop % 2])) {
+            hop++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(20, hop);
+    EXPECT_EQ(0, torn.load());
+    EXPECT_EQ(GameState::ACTIVE, game.getState());
+}
+
+TEST(ConcurrentGameTest, WaitersSleepThroughASlowCommand) {
+    Game game([](GameState state) {
+        if (state == GameState::WAITING_FOR_SETTINGS) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        }
+    }, std::make_unique<ManualClock>());
+    GameSettings settings{};
+    settings.tick_rate_ms = 100;
+    settings.fen_string = "standard";
+
+    std::thread applier([&]() { game.applySettings(settings); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::clock_t cpu_start = std::clock();
+    game.start();
+    double cpu_ms = 1000.0 * (std::clock() - cpu_start) / CLOCKS_PER_SEC;
+    applier.join();
+
+    EXPECT_EQ(GameState::ACTIVE, game.getState());
+    // Spinning for the rest of the 200 ms would burn most of it.
+    EXPECT_LT(cpu_ms, 60.0);
+}
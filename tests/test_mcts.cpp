@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "../bot/ai_player.h"
+#include "../bot/mcts.h"
+
+TEST(MctsTest, TakesUndefendedQueen) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("4k3/8/8/3q4/8/4N3/8/4K3"));
+
+    Mcts mcts(PlayerColor::WHITE, 10, 10);
+    MctsLimits limits;
+    limits.max_playouts = 4000;
+    MctsResult result = mcts.run(board, limits);
+
+    ASSERT_TRUE(result.best_move.has_value());
+    EXPECT_EQ(squareIndex(4, 3), squareIndex(result.best_move->to));
+    EXPECT_EQ(4000u, result.playouts);
+    EXPECT_GT(result.playouts_per_second, 0.0);
+}
+
+TEST(MctsTest, WaitsWhenEveryPieceIsCooling) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("4k3/8/8/8/8/8/8/4K3"));
+    board.setPieceCooldown(board.findPieceAt({0, 4})->id, 30);
+
+    Mcts mcts(PlayerColor::WHITE, 10, 10);
+    MctsResult result = mcts.run(board, MctsLimits());
+
+    EXPECT_FALSE(result.best_move.has_value());
+    EXPECT_EQ(0u, result.playouts);
+}
+
+TEST(MctsTest, ParallelPlayoutsShareTree) {
+    Board board;
+    board.setupStandardPosition();
+
+    Mcts mcts(PlayerColor::BLACK, 10, 10);
+    MctsLimits limits;
+    limits.max_playouts = 2000;
+    limits.threads = 4;
+    MctsResult result = mcts.run(board, limits);
+
+    EXPECT_GE(result.playouts, 2000u);
+    EXPECT_GE(result.value, 0.0);
+    EXPECT_LE(result.value, 1.0);
+}
+
+TEST(MctsTest, SelectableAsAIPlayerEngine) {
+    AIPlayer player(AIDifficulty::MEDIUM, PlayerColor::WHITE, AIEngine::MCTS);
+    EXPECT_EQ(AIEngine::MCTS, player.getEngine());
+    player.setDifficulty(AIDifficulty::EXPERT);
+    EXPECT_EQ(AIEngine::MCTS, player.getEngine());
+
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("4k3/8/8/3q4/8/4N3/8/4K3"));
+    auto move = player.getBestMove(board, 10, 10, SearchLimits::Clock::now() + std::chrono::milliseconds(200));
+    EXPECT_GT(player.getLastMcts().playouts, 0u);
+    EXPECT_GT(player.getLastMcts().playouts_per_second, 0.0);
+    (void)move;
+}
@@ -66,4 +66,47 @@ TEST_F(MoveValidatorTest, BlockedMove) {
 
     board.movePiece(pawn->id, {3, 1});
     EXPECT_TRUE(validator.isValidMove(board, bishop->id, {2, 0}));
-}
\ No newline at end of file
+}
+TEST_F(MoveValidatorTest, GeneratorMatchesSquareProbing) {
+    const char* positions[] = {
+            "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR",
+            "r3k2r/pppq1ppp/2n2n2/2bpp3/2B1P1b1/2NP1N2/PPPQ1PPP/R3K2R",
+            "4k3/1P6/8/3pP3/2Q5/8/6p1/R3K1NR",
+            "k7/8/8/8/8/8/8/1R2K2R",
+    };
+
+    for (const char* fen : positions) {
+        Board position;
+        ASSERT_TRUE(position.setupFromFEN(fen));
+
+        for (const auto& piece : position.getAllPieces()) {
+            std::vector<Position> probed;
+            for (int row = 0; row < 8; row++) {
+                for (int col = 0; col < 8; col++) {
+                    if (validator.isValidMove(position, piece.id, {row, col})) {
+                        probed.push_back({row, col});
+                    }
+                }
+            }
+            EXPECT_EQ(probed, validator.getValidMoves(position, piece.id)) << fen << " piece " << piece.id;
+        }
+
+        std::vector<Move> all_moves;
+        validator.generateAllMoves(position, all_moves);
+        for (const auto& move : all_moves) {
+            EXPECT_TRUE(validator.isValidMove(position, move.piece_id, move.to));
+        }
+    }
+}
+
+TEST_F(MoveValidatorTest, GeneratorSkipsPiecesOnCooldown) {
+    std::vector<Move> moves;
+    validator.generateMoves(board, PlayerColor::WHITE, moves);
+    EXPECT_EQ(20u, moves.size());
+
+    auto knight = board.getPieceAt({0, 1});
+    board.setPieceCooldown(knight->id, 3);
+    moves.clear();
+    validator.generateMoves(board, PlayerColor::WHITE, moves);
+    EXPECT_EQ(18u, moves.size());
+}
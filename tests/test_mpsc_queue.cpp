@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include "../utility/mpsc_queue.h"
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST(MpscQueueTest, PopsInPushOrder) {
+    MpscQueue<std::unique_ptr<int>> queue;
+    std::unique_ptr<int> value;
+    EXPECT_FALSE(queue.pop(value));
+
+    for (int i = 0; i < 3; i++) {
+        queue.push(std::make_unique<int>(i));
+    }
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(queue.pop(value));
+        EXPECT_EQ(i, *value);
+    }
+    EXPECT_FALSE(queue.pop(value));
+}
+
+TEST(MpscQueueTest, KeepsEveryPushFromManyProducers) {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 10000;
+    MpscQueue<int> queue;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; p++) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < kPerProducer; i++) {
+                queue.push(p * kPerProducer + i);
+            }
+        });
+    }
+
+    // Each producer's values come out in the order it pushed them.
+    std::vector<int> last(kProducers, -1);
+    int popped = 0;
+    int value;
+    while (popped < kProducers * kPerProducer) {
+        if (!queue.pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        int producer = value / kPerProducer;
+        EXPECT_LT(last[producer], value);
+        last[producer] = value;
+        popped++;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_FALSE(queue.pop(value));
+}
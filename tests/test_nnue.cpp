@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include "../bot/nnue.h"
+#include "../bot/search.h"
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+const char* const kPositions[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR",
+        "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R",
+        "r3k2r/pp1n1ppp/2p1pn2/q2p4/2PP4/2N1PN2/PPQ2PPP/R3KB1R",
+        "4k3/P7/8/8/8/8/5q2/4K3",
+};
+
+nnue::Network randomNetwork(uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> feature(-20, 20);
+    std::uniform_int_distribution<int> output(-50, 50);
+    nnue::Network network;
+    for (auto& weight : network.feature_weights) {
+        weight = static_cast<int16_t>(feature(rng));
+    }
+    for (auto& bias : network.feature_bias) {
+        bias = static_cast<int16_t>(feature(rng) * 3);
+    }
+    for (auto& weight : network.output_weights) {
+        weight = static_cast<int16_t>(output(rng));
+    }
+    network.output_bias = 1234;
+    network.output_scale = 16;
+    return network;
+}
+
+}
+
+TEST(NnueTest, PieceSquareNetworkMatchesHandEvaluation) {
+    nnue::Network network = nnue::Network::fromPieceSquare();
+    for (const char* fen : kPositions) {
+        Board board;
+        ASSERT_TRUE(board.setupFromFEN(fen));
+        for (PlayerColor side : {PlayerColor::WHITE, PlayerColor::BLACK}) {
+            EXPECT_NEAR(Search::evaluate(board, side), nnue::evaluate(network, board, side), 8) << fen;
+        }
+    }
+}
+
+TEST(NnueTest, CoolingPiecesCountForLess) {
+    nnue::Network network = nnue::Network::fromPieceSquare();
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN(kPositions[2]));
+    int ready = nnue::evaluate(network, board, PlayerColor::WHITE);
+
+    const Piece* queen = board.findPieceAt({1, 2});
+    ASSERT_NE(nullptr, queen);
+    ASSERT_EQ(PieceType::QUEEN, queen->type);
+    board.setPieceCooldown(queen->id, 10);
+    EXPECT_NEAR(ready - 90, nnue::evaluate(network, board, PlayerColor::WHITE), 4);
+}
+
+TEST(NnueTest, IncrementalAccumulatorMatchesReset) {
+    nnue::Network network = randomNetwork(7);
+    MoveValidator validator;
+    std::mt19937 rng(11);
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN(kPositions[1]));
+
+    nnue::Accumulator incremental;
+    incremental.reset(network, board);
+    PlayerColor side = PlayerColor::WHITE;
+    for (int step = 0; step < 200; step++) {
+        std::vector<Move> moves;
+        validator.generateMoves(board, side, moves);
+        if (moves.empty() || !board.pieces(side, PieceType::KING)) {
+            ASSERT_TRUE(board.setupFromFEN(kPositions[1]));
+        } else if (step % 7 == 6) {
+            board.advanceCooldowns(static_cast<int>(rng() % 5));
+        } else {
+            const Move& move = moves[rng() % moves.size()];
+            board.makeMove(move.piece_id, move.to, static_cast<int>(rng() % 6));
+        }
+        side = opponentColor(side);
+
+        incremental.refresh(network, board);
+        for (PlayerColor perspective : {PlayerColor::WHITE, PlayerColor::BLACK}) {
+            ASSERT_EQ(nnue::evaluate(network, board, perspective), incremental.evaluate(network, perspective))
+                    << "step " << step;
+        }
+    }
+    EXPECT_LT(incremental.resets(), 10u);
+}
+
+TEST(NnueTest, SimdBackendsAgree) {
+    nnue::Network network = randomNetwork(3);
+    nnue::SimdBackend original = nnue::simdBackend();
+    for (const char* fen : kPositions) {
+        Board board;
+        ASSERT_TRUE(board.setupFromFEN(fen));
+        ASSERT_TRUE(nnue::setSimdBackend(nnue::SimdBackend::SCALAR));
+        int expected = nnue::evaluate(network, board, PlayerColor::WHITE);
+        for (nnue::SimdBackend backend : {nnue::SimdBackend::SSE2, nnue::SimdBackend::AVX2}) {
+            if (nnue::setSimdBackend(backend)) {
+                EXPECT_EQ(expected, nnue::evaluate(network, board, PlayerColor::WHITE)) << fen;
+            }
+        }
+    }
+    nnue::setSimdBackend(original);
+}
+
+TEST(NnueTest, SaveLoadRoundTrip) {
+    std::string path = testing::TempDir() + "speedchess_test.nnue";
+    nnue::Network network = randomNetwork(5);
+    ASSERT_TRUE(network.save(path));
+
+    nnue::Network loaded;
+    ASSERT_TRUE(loaded.load(path));
+    EXPECT_EQ(network.feature_weights, loaded.feature_weights);
+    EXPECT_EQ(network.feature_bias, loaded.feature_bias);
+    EXPECT_EQ(network.output_weights, loaded.output_weights);
+    EXPECT_EQ(network.output_bias, loaded.output_bias);
+    EXPECT_EQ(network.output_scale, loaded.output_scale);
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(nullptr, file);
+    std::fputs("not a network", file);
+    std::fclose(file);
+    EXPECT_FALSE(loaded.load(path));
+    EXPECT_EQ(network.feature_weights, loaded.feature_weights);
+    EXPECT_FALSE(loaded.load(path + ".missing"));
+    std::remove(path.c_str());
+}
+
+TEST(NnueTest, SearchWithNetworkTakesHangingQueen) {
+    nnue::Network network = nnue::Network::fromPieceSquare();
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("4k3/8/8/3q4/8/8/8/3RK3"));
+    SearchLimits limits;
+    limits.max_depth = 3;
+    limits.network = &network;
+    Search search(PlayerColor::WHITE, 10, 10);
+    SearchResult result = search.run(board, limits);
+    ASSERT_TRUE(result.best_move.has_value());
+    EXPECT_EQ((Position{4, 3}), result.best_move->to);
+    EXPECT_GT(result.score, 400);
+}
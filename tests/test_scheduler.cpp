@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "../utility/scheduler.h"
+#include "../utility/timing_wheel.h"
+#include <atomic>
+
+namespace {
+
+// Ticks at which the callbacks fired, in firing order.
+std::vector<TimingWheel::Tick> fireAll(TimingWheel& wheel, TimingWheel::Tick until) {
+    std::vector<TimingWheel::Tick> fired;
+    std::vector<TimingWheel::Expired> expired;
+    while (wheel.size() > 0 && wheel.nextEventTick() <= until) {
+        wheel.advance(wheel.nextEventTick(), expired);
+        for (auto& entry : expired) {
+            entry.callback();
+            fired.push_back(wheel.now());
+        }
+        expired.clear();
+    }
+    return fired;
+}
+
+}
+
+TEST(TimingWheelTest, FiresInExpiryOrderAcrossLevels) {
+    TimingWheel wheel(5);
+    std::vector<TimingWheel::Tick> order;
+    const TimingWheel::Tick expiries[] = {300000, 7, 70, 4200, 63, 64, 5000000, 100000000};
+    for (TimingWheel::Tick expiry : expiries) {
+        wheel.insert(expiry, [&order, expiry] { order.push_back(expiry); });
+    }
+    EXPECT_EQ(8u, wheel.size());
+
+    std::vector<TimingWheel::Tick> fired = fireAll(wheel, TimingWheel::kNoTick - 1);
+    std::vector<TimingWheel::Tick> expected = {7, 63, 64, 70, 4200, 300000, 5000000, 100000000};
+    EXPECT_EQ(expected, order);
+    EXPECT_EQ(expected, fired);
+    EXPECT_EQ(0u, wheel.size());
+}
+
+TEST(TimingWheelTest, AdvanceSkipsIdleTicks) {
+    TimingWheel wheel;
+    std::vector<TimingWheel::Expired> expired;
+    wheel.insert(1000, [] {});
+    EXPECT_LE(wheel.nextEventTick(), 1000u);
+
+    wheel.advance(999, expired);
+    EXPECT_TRUE(expired.empty());
+    EXPECT_EQ(999u, wheel.now());
+    wheel.advance(5000, expired);
+    EXPECT_EQ(1u, expired.size());
+    EXPECT_EQ(5000u, wheel.now());
+    EXPECT_EQ(TimingWheel::kNoTick, wheel.nextEventTick());
+}
+
+TEST(TimingWheelTest, CancelledTimersNeverFire) {
+    TimingWheel wheel;
+    int fired = 0;
+    TimingWheel::Handle near = wheel.insert(10, [&] { fired++; });
+    TimingWheel::Handle far = wheel.insert(100000, [&] { fired++; });
+    wheel.insert(20, [&] { fired += 10; });
+
+    EXPECT_TRUE(wheel.cancel(near));
+    EXPECT_TRUE(wheel.cancel(far));
+    EXPECT_FALSE(wheel.cancel(far));
+    EXPECT_EQ(1u, wheel.size());
+
+    fireAll(wheel, 200000);
+    EXPECT_EQ(10, fired);
+}
+
+TEST(TimingWheelTest, PastExpiriesFireOnTheNextTick) {
+    TimingWheel wheel(100);
+    std::vector<TimingWheel::Expired> expired;
+    TimingWheel::Handle handle = wheel.insert(50, [] {});
+    EXPECT_EQ(101u, wheel.nextEventTick());
+    wheel.advance(101, expired);
+    ASSERT_EQ(1u, expired.size());
+    EXPECT_EQ(handle, expired[0].handle);
+    EXPECT_FALSE(wheel.cancel(handle));
+}
+
+TEST(SchedulerTest, RunsTimersNoEarlierThanAsked) {
+    Scheduler scheduler(2);
+    std::atomic<int> fired(0);
+    std::atomic<bool> early(false);
+    auto start = Scheduler::Clock::now();
+    for (int i = 0; i < 100; i++) {
+        auto when = start + std::chrono::milliseconds(i % 20);
+        scheduler.schedule(when, [&, when] {
+            if (Scheduler::Clock::now() < when) {
+                early = true;
+            }
+            fired++;
+        });
+    }
+
+    auto deadline = start + std::chrono::seconds(5);
+    while (fired < 100 && Scheduler::Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(100, fired.load());
+    EXPECT_FALSE(early);
+    EXPECT_EQ(0u, scheduler.pending());
+}
+
+TEST(SchedulerTest, CancelledTimersDoNotRun) {
+    Scheduler scheduler(1);
+    std::atomic<int> fired(0);
+    auto when = Scheduler::Clock::now() + std::chrono::milliseconds(30);
+    Scheduler::TimerId cancelled = scheduler.schedule(when, [&] { fired += 100; });
+    scheduler.schedule(when, [&] { fired++; });
+    EXPECT_EQ(2u, scheduler.pending());
+
+    EXPECT_TRUE(scheduler.cancel(cancelled));
+    EXPECT_FALSE(scheduler.cancel(cancelled));
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(1, fired.load());
+}
+
+TEST(SchedulerClockTest, StopFreezesGameTime) {
+    Scheduler scheduler(1);
+    SchedulerClock clock(scheduler);
+    std::atomic<int> wakes(0);
+    clock.start([&] { wakes++; });
+    clock.wakeAt(std::chrono::milliseconds(5));
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_EQ(1, wakes.load());
+
+    clock.stop();
+    ClockSource::Time frozen = clock.now();
+    clock.wakeAt(frozen + std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(frozen, clock.now());
+    EXPECT_EQ(1, wakes.load());
+
+    // The wake-up requested while stopped is armed on restart.
+    clock.start([&] { wakes++; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_EQ(2, wakes.load());
+    EXPECT_GT(clock.now(), frozen);
+}
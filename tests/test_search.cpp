@@ -0,0 +1,261 @@
+#include <gtest/gtest.h>
+#include "../bot/ai_player.h"
+#include "../bot/search.h"
+#include "../core/attack_tables.h"
+#include "../utility/fen_parser.h"
+
+TEST(SearchTest, RestoresBoardAfterSearch) {
+    Board board;
+    board.setupStandardPosition();
+    std::string fen = FENParser::boardToFEN(board);
+    uint64_t hash = board.hash();
+
+    Search search(PlayerColor::WHITE, 10, 10);
+    SearchLimits limits;
+    limits.max_depth = 3;
+    SearchResult result = search.run(board, limits);
+
+    ASSERT_TRUE(result.best_move.has_value());
+    EXPECT_GT(result.nodes, 0u);
+    EXPECT_EQ(fen, FENParser::boardToFEN(board));
+    EXPECT_EQ(hash, board.hash());
+    EXPECT_EQ(board.computeHash(), board.hash());
+}
+
+TEST(SearchTest, CapturesHangingQueen) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("4k3/8/8/3q4/8/8/3R4/4K3"));
+
+    Search search(PlayerColor::WHITE, 10, 10);
+    SearchLimits limits;
+    limits.max_depth = 2;
+    SearchResult result = search.run(board, limits);
+
+    ASSERT_TRUE(result.best_move.has_value());
+    EXPECT_EQ((Position{4, 3}), result.best_move->to);
+}
+
+TEST(SearchTest, FindsKingCaptureAcrossCooldownInterval) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("7k/8/8/4N3/8/n7/1P6/4K3"));
+    for (const auto& piece : board.getPlayerPieces(PlayerColor::BLACK)) {
+        board.setPieceCooldown(piece.id, 100);
+    }
+
+    Search search(PlayerColor::WHITE, 10, 10);
+    SearchLimits limits;
+    limits.max_depth = 3;
+    limits.tick_step = 10;
+    SearchResult result = search.run(board, limits);
+
+    ASSERT_TRUE(result.best_move.has_value());
+    auto knight = board.getPieceAt({4, 4});
+    ASSERT_TRUE(knight.has_value());
+    EXPECT_EQ(knight->id, result.best_move->piece_id);
+    EXPECT_TRUE(attacks::knightAttacks(squareIndex(result.best_move->to)) & squareBit(Position{7, 7}));
+    EXPECT_GT(result.score, Search::kMateScore - 10);
+}
+
+TEST(SearchTest, IterativeDeepeningReportsCompletedDepth) {
+    Board board;
+    board.setupStandardPosition();
+
+    Search search(PlayerColor::WHITE, 10, 10);
+    SearchLimits limits;
+    limits.max_depth = 3;
+    SearchResult result = search.run(board, limits);
+
+    EXPECT_EQ(3, result.depth);
+    EXPECT_FALSE(result.stopped);
+}
+
+TEST(SearchTest, StopsAtNodeBudgetWithMove) {
+    Board board;
+    board.setupStandardPosition();
+    std::string fen = FENParser::boardToFEN(board);
+
+    Search search(PlayerColor::WHITE, 10, 10);
+    SearchLimits limits;
+    limits.max_depth = 32;
+    limits.max_nodes = 5000;
+    SearchResult result = search.run(board, limits);
+
+    ASSERT_TRUE(result.best_move.has_value());
+    EXPECT_TRUE(result.stopped);
+    EXPECT_LT(result.depth, 32);
+    EXPECT_LE(result.nodes, limits.max_nodes);
+    EXPECT_EQ(fen, FENParser::boardToFEN(board));
+}
+
+TEST(SearchTest, ExpiredDeadlineStillReturnsMove) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("4k3/8/8/3q4/8/8/3R4/4K3"));
+
+    Search search(PlayerColor::WHITE, 10, 10);
+    SearchLimits limits;
+    limits.max_depth = 32;
+    limits.deadline = SearchLimits::Clock::now();
+    SearchResult result = search.run(board, limits);
+
+    ASSERT_TRUE(result.best_move.has_value());
+    EXPECT_TRUE(result.stopped);
+    EXPECT_EQ(0, result.depth);
+    EXPECT_EQ(squareIndex(4, 3), squareIndex(result.best_move->to.row, result.best_move->to.col));
+}
+
+TEST(SearchTest, ParallelSearchSharesTableAndRestoresBoard) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("4k3/8/8/3q4/8/8/3R4/4K3"));
+    std::string fen = FENParser::boardToFEN(board);
+    TranspositionTable table(4);
+
+    SearchLimits limits;
+    limits.max_depth = 4;
+    SearchResult result = searchParallel(board, PlayerColor::WHITE, 10, 10, limits, &table, 4);
+
+    ASSERT_TRUE(result.best_move.has_value());
+    EXPECT_EQ(squareIndex(4, 3), squareIndex(result.best_move->to));
+    EXPECT_EQ(4, result.depth);
+    EXPECT_GT(table.stats().probes, 0u);
+    EXPECT_EQ(fen, FENParser::boardToFEN(board));
+}
+
+TEST(SearchTest, TableKeepsCooldownIntervalsApart) {
+    SearchLimits limits;
+    limits.max_depth = 2;
+    limits.tick_step = 10;
+
+    // Table hits of a search with the black queen `second` ticks from
+    // ready, after one with it `first` ticks away filled the table.
+    auto hits = [&limits](int first, int second) {
+        TranspositionTable table(1);
+        for (int ticks : {first, second}) {
+            Board board;
+            EXPECT_TRUE(board.setupFromFEN("4k3/8/8/3q4/8/8/3R4/4K3"));
+            board.setPieceCooldown(board.findPieceAt({4, 3})->id, ticks);
+            Search search(PlayerColor::WHITE, 10, 10, &table);
+            SearchResult result = search.run(board, limits);
+            if (ticks == second) {
+                return result.tt_hits;
+            }
+        }
+        return uint64_t(0);
+    };
+
+    // Ready after the same interval: the first search's entries are reused.
+    uint64_t alone = hits(0, 5);
+    EXPECT_GT(hits(8, 5), alone);
+    // One interval versus two: same placement, but no shared entries.
+    EXPECT_EQ(alone, hits(25, 5));
+}
+
+TEST(SearchTest, StateDropsPlanThroughChangedSquares) {
+    Board before;
+    ASSERT_TRUE(before.setupFromFEN("4k3/p7/8/8/8/8/8/R3K3"));
+    Board after;
+    ASSERT_TRUE(after.setupFromFEN("4k3/8/p7/8/8/8/8/R3K3"));
+
+    SearchState state;
+    EXPECT_EQ(~Bitboard(0), state.update(before));
+
+    SearchResult result;
+    const Piece* rook = before.findPieceAt({0, 0});
+    const Piece* king = before.findPieceAt({0, 4});
+    result.pv.push_back(Move{king->id, {0, 4}, {1, 4}, 0});
+    result.pv.push_back(Move{0, {0, 0}, {0, 0}, 0});
+    result.pv.push_back(Move{rook->id, {0, 0}, {7, 0}, 0});
+    state.record(result);
+    state.setReply(king->id, Move{rook->id, {0, 0}, {3, 0}, 0});
+
+    // a7-a6 lands on the rook's path: its steps go, the king step stays.
+    Bitboard changed = state.update(after);
+    EXPECT_EQ(squareBit(squareIndex(6, 0)) | squareBit(squareIndex(5, 0)), changed);
+    ASSERT_EQ(2u, state.principalVariation().size());
+    EXPECT_EQ(king->id, state.principalVariation().front().piece_id);
+    EXPECT_EQ(rook->id, state.reply(king->id).piece_id);
+
+    Board later;
+    ASSERT_TRUE(later.setupFromFEN("4k3/8/8/8/p7/8/8/R3K3"));
+    state.update(later);
+    EXPECT_EQ(0u, state.reply(king->id).piece_id);
+}
+
+TEST(SearchTest, StateKeepsPlanPastPlayedSteps) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("4k3/p7/8/8/8/8/8/R3K3"));
+    uint32_t rook = board.findPieceAt({0, 0})->id;
+    uint32_t king = board.findPieceAt({0, 4})->id;
+    uint32_t pawn = board.findPieceAt({6, 0})->id;
+
+    SearchState state;
+    state.update(board);
+    SearchResult planned;
+    planned.pv.push_back(Move{rook, {0, 0}, {0, 3}, 0});
+    planned.pv.push_back(Move{pawn, {6, 0}, {5, 0}, 0});
+    planned.pv.push_back(Move{king, {0, 4}, {1, 5}, 0});
+    planned.pv.push_back(Move{0, {0, 0}, {0, 0}, 0});
+    planned.pv.push_back(Move{rook, {0, 3}, {6, 3}, 0});
+    state.record(planned);
+
+    // Both sides play the plan: what is left of it survives, the rook's
+    // path through its own old square included.
+    Board played = board;
+    played.makeMove(rook, {0, 3});
+    played.makeMove(pawn, {5, 0});
+    state.update(played);
+    ASSERT_EQ(3u, state.principalVariation().size());
+    EXPECT_EQ(king, state.principalVariation().front().piece_id);
+    EXPECT_EQ(rook, state.principalVariation().back().piece_id);
+
+    // With no time to search, the next planned move is the one tried first.
+    Search search(PlayerColor::WHITE, 0, 0);
+    search.setState(&state);
+    SearchLimits limits;
+    limits.max_depth = 32;
+    limits.deadline = SearchLimits::Clock::now();
+    SearchResult result = search.run(played, limits);
+    ASSERT_TRUE(result.best_move.has_value());
+    EXPECT_EQ(king, result.best_move->piece_id);
+    EXPECT_EQ((Position{1, 5}), result.best_move->to);
+
+    // The opponent answers differently, onto the rook's path: the king step
+    // stays, the rook step goes.
+    state.clear();
+    state.update(board);
+    state.record(planned);
+    Board deviated = board;
+    deviated.makeMove(rook, {0, 3});
+    deviated.makeMove(board.findPieceAt({7, 4})->id, {6, 3});
+    state.update(deviated);
+    ASSERT_EQ(2u, state.principalVariation().size());
+    EXPECT_EQ(king, state.principalVariation().front().piece_id);
+}
+
+TEST(SearchTest, ReusedStateCutsCostAfterQuietMove) {
+    SearchLimits limits;
+    limits.max_depth = 4;
+
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("r3k3/pp3ppp/2n5/3q4/8/2N5/PP3PPP/R2QK3"));
+    AIPlayer player(AIDifficulty::HARD, PlayerColor::WHITE);
+    player.setSearchLimits(limits);
+    auto no_deadline = SearchLimits::Clock::time_point::max();
+    player.getBestMove(board, 10, 10, no_deadline);
+    EXPECT_FALSE(player.getLastSearch().pv.empty());
+
+    // Black answers with a quiet move on the far wing.
+    const Piece* pawn = board.findPieceAt({6, 7});
+    ASSERT_NE(nullptr, pawn);
+    board.makeMove(pawn->id, {5, 7}, 10);
+
+    auto reused_move = player.getBestMove(board, 10, 10, no_deadline);
+    uint64_t reused_nodes = player.getLastSearch().nodes;
+
+    AIPlayer fresh(AIDifficulty::HARD, PlayerColor::WHITE);
+    fresh.setSearchLimits(limits);
+    auto fresh_move = fresh.getBestMove(board, 10, 10, no_deadline);
+
+    ASSERT_TRUE(reused_move.has_value());
+    ASSERT_TRUE(fresh_move.has_value());
+    EXPECT_LT(reused_nodes, fresh.getLastSearch().nodes);
+}
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+#include "../core/sliding_attacks.h"
+#include "../core/move_validator.h"
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+// The square-by-square path walk MoveValidator used before the lookup tables.
+bool isPathClear(Bitboard occupied, Position from, Position to) {
+    int row_dir = (from.row < to.row) ? 1 : (from.row > to.row) ? -1 : 0;
+    int col_dir = (from.col < to.col) ? 1 : (from.col > to.col) ? -1 : 0;
+
+    Position current = {from.row + row_dir, from.col + col_dir};
+    while (current != to) {
+        if (occupied & squareBit(current)) {
+            return false;
+        }
+        current.row += row_dir;
+        current.col += col_dir;
+    }
+    return true;
+}
+
+Bitboard walkRook(int square, Bitboard occupied) {
+    Position from = squarePosition(square);
+    Bitboard result = 0;
+    for (int target = 0; target < kSquareCount; target++) {
+        Position to = squarePosition(target);
+        if (target != square && (to.row == from.row || to.col == from.col) && isPathClear(occupied, from, to)) {
+            result |= squareBit(target);
+        }
+    }
+    return result;
+}
+
+Bitboard walkBishop(int square, Bitboard occupied) {
+    Position from = squarePosition(square);
+    Bitboard result = 0;
+    for (int target = 0; target < kSquareCount; target++) {
+        Position to = squarePosition(target);
+        if (target != square && std::abs(to.row - from.row) == std::abs(to.col - from.col) &&
+            isPathClear(occupied, from, to)) {
+            result |= squareBit(target);
+        }
+    }
+    return result;
+}
+
+std::vector<Bitboard> sampleOccupancies() {
+    std::mt19937_64 rng(20240607);
+    std::vector<Bitboard> samples = {0, ~Bitboard{0}, 0x00FF00000000FF00ULL};
+    for (int i = 0; i < 300; i++) {
+        samples.push_back(rng() & rng());
+        samples.push_back(rng() & rng() & rng());
+    }
+    return samples;
+}
+
+}
+
+TEST(SlidingAttacksTest, MagicMatchesPathWalk) {
+    for (Bitboard occupied : sampleOccupancies()) {
+        for (int square = 0; square < kSquareCount; square++) {
+            ASSERT_EQ(walkRook(square, occupied), attacks::rookAttacksMagic(square, occupied)) << square;
+            ASSERT_EQ(walkBishop(square, occupied), attacks::bishopAttacksMagic(square, occupied)) << square;
+        }
+    }
+}
+
+TEST(SlidingAttacksTest, PextMatchesPathWalk) {
+    if (!attacks::pextSupported()) {
+        GTEST_SKIP() << "BMI2 not available on this CPU";
+    }
+
+    for (Bitboard occupied : sampleOccupancies()) {
+        for (int square = 0; square < kSquareCount; square++) {
+            ASSERT_EQ(walkRook(square, occupied), attacks::rookAttacksPext(square, occupied)) << square;
+            ASSERT_EQ(walkBishop(square, occupied), attacks::bishopAttacksPext(square, occupied)) << square;
+        }
+    }
+}
+
+TEST(SlidingAttacksTest, ValidatorExposesSliderAttacks) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("4k3/8/8/3p4/8/1Q6/8/4K3"));
+    auto queen = board.getPieceAt({2, 1});
+    ASSERT_TRUE(queen.has_value());
+
+    MoveValidator validator;
+    Bitboard expected = walkRook(squareIndex(2, 1), board.occupancy()) |
+                        walkBishop(squareIndex(2, 1), board.occupancy());
+    EXPECT_EQ(expected, validator.getAttacks(board, *queen));
+    EXPECT_TRUE(validator.isValidMove(board, queen->id, {4, 3}));
+    EXPECT_FALSE(validator.isValidMove(board, queen->id, {5, 4}));
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include "../utility/snapshot_publisher.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Pair {
+    int first = 0;
+    int second = 0;
+};
+
+void publishValue(SnapshotPublisher<Pair>& publisher, int value) {
+    Pair& next = publisher.prepare();
+    next.first = value;
+    next.second = value;
+    publisher.publish();
+}
+
+}
+
+TEST(SnapshotPublisherTest, ReaderKeepsItsValueAcrossPublications) {
+    SnapshotPublisher<Pair> publisher;
+    EXPECT_EQ(0, publisher.acquire()->first);
+
+    publishValue(publisher, 1);
+    auto held = publisher.acquire();
+    for (int value = 2; value < 20; value++) {
+        publishValue(publisher, value);
+    }
+
+    EXPECT_EQ(1, held->first);
+    EXPECT_EQ(19, publisher.acquire()->first);
+}
+
+TEST(SnapshotPublisherTest, ReusesSlotsOnceReleased) {
+    SnapshotPublisher<Pair> publisher;
+    uint32_t capacity = publisher.capacity();
+    for (int value = 1; value < 1000; value++) {
+        auto reader = publisher.acquire();
+        publishValue(publisher, value);
+    }
+    EXPECT_EQ(capacity, publisher.capacity());
+
+    // Holding more values than there are spare slots grows the pool.
+    std::vector<SnapshotPublisher<Pair>::Ref> held;
+    for (int value = 0; value < 10; value++) {
+        held.push_back(publisher.acquire());
+        publishValue(publisher, value);
+    }
+    EXPECT_GT(publisher.capacity(), capacity);
+    for (int value = 0; value < 10; value++) {
+        EXPECT_EQ(value - 1 < 0 ? 999 : value - 1, held[value]->first);
+    }
+}
+
+TEST(SnapshotPublisherTest, ReadersNeverSeeAHalfWrittenValue) {
+    SnapshotPublisher<Pair> publisher;
+    std::atomic<bool> done{false};
+    std::atomic<int> torn{0};
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < 3; i++) {
+        readers.emplace_back([&]() {
+            int last = 0;
+            while (!done) {
+                auto value = publisher.acquire();
+                if (value->first != value->second || value->first < last) {
+                    torn++;
+                }
+                last = value->first;
+            }
+        });
+    }
+    for (int value = 1; value <= 20000; value++) {
+        publishValue(publisher, value);
+    }
+    done = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    EXPECT_EQ(0, torn.load());
+    EXPECT_EQ(20000, publisher.acquire()->first);
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "../core/static_exchange.h"
+#include "../core/move_validator.h"
+
+namespace {
+
+int exchangeFor(const Board& board, Position from, Position to) {
+    const Piece* piece = board.findPieceAt(from);
+    EXPECT_NE(nullptr, piece);
+    return piece ? eval::staticExchange(board, piece->id, to) : 0;
+}
+
+}
+
+TEST(StaticExchangeTest, UndefendedCaptureWinsVictim) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("4k3/8/8/3p4/8/8/8/3RK3"));
+    EXPECT_EQ(100, exchangeFor(board, {0, 3}, {4, 3}));
+}
+
+TEST(StaticExchangeTest, DefendedPawnCostsTheQueen) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("4k3/8/2p5/3p4/8/8/8/3QK3"));
+    EXPECT_EQ(100 - 900, exchangeFor(board, {0, 3}, {4, 3}));
+}
+
+TEST(StaticExchangeTest, CoolingDefenderDoesNotRecapture) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("4k3/8/2p5/3p4/8/8/8/3QK3"));
+    const Piece* defender = board.findPieceAt({5, 2});
+    ASSERT_NE(nullptr, defender);
+    ASSERT_TRUE(board.setPieceCooldown(defender->id, 5));
+    EXPECT_EQ(100, exchangeFor(board, {0, 3}, {4, 3}));
+
+    board.decrementCooldowns();
+    board.advanceCooldowns(4);
+    EXPECT_EQ(100 - 900, exchangeFor(board, {0, 3}, {4, 3}));
+}
+
+TEST(StaticExchangeTest, XRayAttackerJoinsTheExchange) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("3rk3/8/5n2/3p4/8/2N5/3R4/3RK3"));
+    EXPECT_EQ(100, exchangeFor(board, {2, 2}, {4, 3}));
+
+    ASSERT_TRUE(board.setupFromFEN("3rk3/8/5n2/3p4/8/2N5/3R4/4K3"));
+    EXPECT_EQ(-200, exchangeFor(board, {2, 2}, {4, 3}));
+}
+
+TEST(StaticExchangeTest, QuietMoveOntoCoveredSquareLosesMover) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("4k3/8/8/8/2p5/8/8/3QK3"));
+    EXPECT_EQ(-900, exchangeFor(board, {0, 3}, {2, 3}));
+    EXPECT_EQ(0, exchangeFor(board, {0, 3}, {1, 3}));
+}
+
+TEST(StaticExchangeTest, PromotionCountsTheNewQueen) {
+    Board board;
+    ASSERT_TRUE(board.setupFromFEN("1r2k3/P7/8/8/8/8/8/4K3"));
+    EXPECT_EQ(500 + 800, exchangeFor(board, {6, 0}, {7, 1}));
+    // The rook takes the new queen on a8.
+    EXPECT_EQ(800 - 900, exchangeFor(board, {6, 0}, {7, 0}));
+}
+
+TEST(StaticExchangeTest, ThresholdAgreesWithFullExchange) {
+    const char* positions[] = {
+            "r3k2r/pp1n1ppp/2p1pn2/q2p4/2PP4/2N1PN2/PPQ2PPP/R3KB1R",
+            "3rk3/8/5n2/3p4/8/2N5/3R4/3RK3",
+            "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R",
+    };
+    MoveValidator validator;
+    for (const char* fen : positions) {
+        Board board;
+        ASSERT_TRUE(board.setupFromFEN(fen));
+        for (PlayerColor color : {PlayerColor::WHITE, PlayerColor::BLACK}) {
+            std::vector<Move> moves;
+            validator.generateMoves(board, color, moves);
+            for (const Move& move : moves) {
+                int exchange = eval::staticExchange(board, move.piece_id, move.to);
+                for (int threshold = -1000; threshold <= 1000; threshold += 50) {
+                    EXPECT_EQ(exchange >= threshold,
+                              eval::exchangeAtLeast(board, move.piece_id, move.to, threshold))
+                            << fen << " threshold " << threshold;
+                }
+            }
+        }
+    }
+}
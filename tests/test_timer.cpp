@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include "../utility/timer.h"
+#include <atomic>
+#include <mutex>
+#include <set>
+
+using std::chrono::milliseconds;
+
+TEST(TimerTest, PeriodicTicksStayOnTheGrid) {
+    Timer timer;
+    timer.setTickRate(10);
+    std::atomic<int> ticks(0);
+    timer.setPeriodic(true);
+    timer.start([&] { ticks++; });
+    std::this_thread::sleep_for(milliseconds(205));
+    timer.stop();
+
+    // Deadlines are absolute, so the count follows elapsed game time
+    // however late individual ticks ran; the last one may not have run yet.
+    int expected = static_cast<int>(timer.now() / milliseconds(10));
+    EXPECT_NEAR(expected, ticks.load(), 1);
+    EXPECT_EQ(static_cast<uint64_t>(ticks.load()), timer.stats().callbacks);
+}
+
+TEST(TimerTest, SkipDropsTicksMissedWhileBehind) {
+    Timer timer;
+    timer.setTickRate(10);
+    timer.setPeriodic(true, Timer::OverrunPolicy::SKIP);
+    std::atomic<int> ticks(0);
+    timer.start([&] {
+        if (ticks++ == 0) {
+            std::this_thread::sleep_for(milliseconds(45));
+        }
+    });
+    std::this_thread::sleep_for(milliseconds(100));
+    timer.stop();
+
+    Timer::Stats stats = timer.stats();
+    EXPECT_GE(stats.missed_ticks, 3u);
+    EXPECT_EQ(stats.callbacks, static_cast<uint64_t>(ticks.load()));
+    EXPECT_LE(ticks.load(), static_cast<int>(timer.now() / milliseconds(10)) - 3);
+}
+
+TEST(TimerTest, CatchUpDeliversEveryTick) {
+    Timer timer;
+    timer.setTickRate(10);
+    timer.setPeriodic(true, Timer::OverrunPolicy::CATCH_UP);
+    std::atomic<int> ticks(0);
+    timer.start([&] {
+        if (ticks++ == 0) {
+            std::this_thread::sleep_for(milliseconds(45));
+        }
+    });
+    std::this_thread::sleep_for(milliseconds(100));
+    timer.stop();
+
+    Timer::Stats stats = timer.stats();
+    EXPECT_EQ(0u, stats.missed_ticks);
+    EXPECT_GE(stats.late_ticks, 3u);
+    EXPECT_NEAR(static_cast<int>(timer.now() / milliseconds(10)), ticks.load(), 1);
+    EXPECT_GE(stats.max_lateness, milliseconds(30));
+    EXPECT_GE(stats.percentile(1.0), milliseconds(30));
+}
+
+TEST(TimerTest, WakeUpOnATickCountsOnce) {
+    Timer timer;
+    timer.setTickRate(10);
+    timer.setPeriodic(true);
+    std::atomic<int> callbacks(0);
+    timer.start([&] { callbacks++; });
+    // Lands on the 30 ms tick: both come due at once and share a callback.
+    timer.wakeAt(milliseconds(30));
+    std::this_thread::sleep_for(milliseconds(55));
+    timer.stop();
+
+    EXPECT_EQ(static_cast<uint64_t>(callbacks.load()), timer.stats().callbacks);
+}
+
+TEST(TimerTest, PauseKeepsTheThreadAndFreezesTime) {
+    Timer timer;
+    std::mutex mutex;
+    std::set<std::thread::id> threads;
+    std::atomic<int> wakes(0);
+    auto callback = [&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        threads.insert(std::this_thread::get_id());
+        wakes++;
+    };
+
+    timer.start(callback);
+    timer.wakeAt(milliseconds(5));
+    std::this_thread::sleep_for(milliseconds(30));
+    timer.stop();
+    ClockSource::Time frozen = timer.now();
+    timer.wakeAt(frozen + milliseconds(5));
+    std::this_thread::sleep_for(milliseconds(20));
+    EXPECT_EQ(1, wakes.load());
+    EXPECT_EQ(frozen, timer.now());
+
+    timer.start(callback);
+    std::this_thread::sleep_for(milliseconds(30));
+    timer.stop();
+    EXPECT_EQ(2, wakes.load());
+    EXPECT_EQ(1u, threads.size());
+}
+
+TEST(SteadyGameTimeTest, BanksTimeAcrossRuns) {
+    SteadyGameTime time;
+    EXPECT_FALSE(time.running());
+    EXPECT_EQ(ClockSource::Time::zero(), time.now());
+
+    time.start();
+    EXPECT_TRUE(time.running());
+    std::this_thread::sleep_until(time.when(milliseconds(20)));
+    EXPECT_GE(time.now(), milliseconds(20));
+
+    time.stop();
+    ClockSource::Time banked = time.now();
+    std::this_thread::sleep_for(milliseconds(10));
+    EXPECT_EQ(banked, time.now());
+
+    time.start();
+    std::this_thread::sleep_until(time.when(banked + milliseconds(10)));
+    EXPECT_GE(time.now(), banked + milliseconds(10));
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+#include "../bot/tournament.h"
+#include <cmath>
+
+TEST(TournamentTest, ParsesPlayerSpec) {
+    PlayerConfig config;
+    ASSERT_TRUE(parsePlayerConfig("name=fast,difficulty=hard,engine=mcts,threads=2,hash=8,movetime=25,reaction=3",
+                                  config));
+    EXPECT_EQ("fast", config.name);
+    EXPECT_EQ(AIDifficulty::HARD, config.difficulty);
+    ASSERT_TRUE(config.engine.has_value());
+    EXPECT_EQ(AIEngine::MCTS, *config.engine);
+    EXPECT_EQ(2, config.threads);
+    EXPECT_EQ(8u, config.hash_megabytes);
+    EXPECT_EQ(25, config.move_time.count());
+    EXPECT_EQ(3, config.reaction_ticks);
+
+    EXPECT_FALSE(parsePlayerConfig("difficulty=impossible", config));
+    EXPECT_FALSE(parsePlayerConfig("threads=0", config));
+    EXPECT_FALSE(parsePlayerConfig("colour=white", config));
+    EXPECT_FALSE(parsePlayerConfig("network=/nonexistent/net.nnue", config));
+}
+
+TEST(TournamentTest, EloFollowsLogisticModel) {
+    EXPECT_DOUBLE_EQ(0.0, eloFromScore(0.5));
+    EXPECT_NEAR(190.85, eloFromScore(0.75), 0.01);
+    EXPECT_NEAR(0.75, scoreFromElo(eloFromScore(0.75)), 1e-12);
+    EXPECT_TRUE(std::isinf(eloFromScore(1.0)));
+
+    MatchScore score;
+    score.wins = 60;
+    score.draws = 20;
+    score.losses = 20;
+    EloEstimate estimate = estimateElo(score);
+    EXPECT_NEAR(eloFromScore(0.7), estimate.elo, 1e-9);
+    EXPECT_LT(estimate.lower, estimate.elo);
+    EXPECT_GT(estimate.upper, estimate.elo);
+    EXPECT_GT(estimate.lower, 0.0);
+}
+
+TEST(TournamentTest, SprtDecidesOnClearResults) {
+    MatchScore even;
+    even.wins = 10;
+    even.draws = 10;
+    even.losses = 10;
+    EXPECT_EQ(SprtDecision::CONTINUE, sprt(even, 0, 10, 0.05, 0.05).decision);
+
+    MatchScore strong;
+    strong.wins = 300;
+    strong.draws = 100;
+    strong.losses = 100;
+    SprtResult accepted = sprt(strong, 0, 10, 0.05, 0.05);
+    EXPECT_EQ(SprtDecision::ACCEPT_H1, accepted.decision);
+    EXPECT_GT(accepted.llr, accepted.upper_bound);
+
+    MatchScore weak;
+    weak.wins = 100;
+    weak.draws = 100;
+    weak.losses = 300;
+    EXPECT_EQ(SprtDecision::ACCEPT_H0, sprt(weak, 0, 10, 0.05, 0.05).decision);
+}
+
+TEST(TournamentTest, GameEndsOnKingCapture) {
+    GameOptions options;
+    options.fen = "4k2Q/8/8/8/8/8/8/4K3";
+    options.max_ticks = 200;
+    PlayerConfig white;
+    white.engine = AIEngine::ALPHA_BETA;
+    PlayerConfig black;
+    black.difficulty = AIDifficulty::EASY;
+
+    // White acts first on the first tick and takes the king.
+    GameRecord record = playGame(options, white, black);
+    EXPECT_EQ(GameResult::WHITE_WIN, record.result);
+    ASSERT_EQ(1u, record.moves.size());
+    EXPECT_EQ(PlayerColor::WHITE, record.moves.back().side);
+    EXPECT_EQ((Position{7, 7}), record.moves.back().move.from);
+    EXPECT_EQ(1, record.ticks);
+}
+
+TEST(TournamentTest, RunsPairedGamesInParallel) {
+    TournamentOptions options;
+    options.games = 4;
+    options.concurrency = 2;
+    options.openings = {"4k2Q/8/8/8/8/8/8/4K3", "Q3k3/8/8/8/8/8/8/4K3"};
+    options.max_ticks = 200;
+    PlayerConfig first;
+    first.engine = AIEngine::ALPHA_BETA;
+    PlayerConfig second = first;
+
+    int callbacks = 0;
+    auto records = runTournament(options, first, second, [&](const GameRecord&, const MatchScore& score) {
+        callbacks++;
+        EXPECT_EQ(callbacks, score.games());
+    });
+    ASSERT_EQ(4u, records.size());
+    EXPECT_EQ(4, callbacks);
+    for (size_t i = 0; i < records.size(); i++) {
+        EXPECT_EQ(static_cast<int>(i), records[i].game_index);
+        EXPECT_EQ(static_cast<int>(i / 2), records[i].opening_index);
+        EXPECT_EQ(i % 2 == 0, records[i].first_is_white);
+    }
+    // White takes the king at once in both openings, so each pair splits.
+    MatchScore score;
+    for (const auto& record : records) {
+        score.add(record.result, record.first_is_white);
+    }
+    EXPECT_EQ(2, score.wins);
+    EXPECT_EQ(2, score.losses);
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include "../bot/search.h"
+#include <thread>
+
+namespace {
+
+TTEntry makeEntry(int score, int depth, Bound bound, uint32_t piece_id = 0, int to_square = 0) {
+    TTEntry entry;
+    entry.score = score;
+    entry.depth = depth;
+    entry.bound = bound;
+    entry.piece_id = piece_id;
+    entry.to_square = to_square;
+    return entry;
+}
+
+}
+
+TEST(TranspositionTableTest, StoresAndProbesEntries) {
+    TranspositionTable table(1);
+    EXPECT_EQ(1u << 20, table.sizeInBytes());
+
+    table.store(0x1234, makeEntry(-99999, 7, Bound::LOWER, 17, 63));
+
+    TTEntry entry;
+    ASSERT_TRUE(table.probe(0x1234, entry));
+    EXPECT_EQ(-99999, entry.score);
+    EXPECT_EQ(7, entry.depth);
+    EXPECT_EQ(Bound::LOWER, entry.bound);
+    EXPECT_EQ(17u, entry.piece_id);
+    EXPECT_EQ(63, entry.to_square);
+
+    EXPECT_FALSE(table.probe(0x1235, entry));
+    table.clear();
+    EXPECT_FALSE(table.probe(0x1234, entry));
+}
+
+TEST(TranspositionTableTest, KeepsDeeperEntryFromSameSearch) {
+    TranspositionTable table(1);
+    table.store(42, makeEntry(10, 6, Bound::LOWER));
+    table.store(42, makeEntry(20, 2, Bound::LOWER));
+
+    TTEntry entry;
+    ASSERT_TRUE(table.probe(42, entry));
+    EXPECT_EQ(6, entry.depth);
+
+    table.newSearch();
+    table.store(42, makeEntry(20, 2, Bound::LOWER));
+    ASSERT_TRUE(table.probe(42, entry));
+    EXPECT_EQ(2, entry.depth);
+}
+
+TEST(TranspositionTableTest, ReplacesOldestShallowEntryInFullCluster) {
+    TranspositionTable table(1);
+    uint64_t stride = table.sizeInBytes() / 64;
+
+    // Five keys that share a cluster; the old shallow one must go.
+    table.store(5, makeEntry(1, 1, Bound::EXACT));
+    table.newSearch();
+    table.store(5 + stride, makeEntry(2, 3, Bound::EXACT));
+    table.store(5 + 2 * stride, makeEntry(3, 4, Bound::EXACT));
+    table.store(5 + 3 * stride, makeEntry(4, 5, Bound::EXACT));
+    table.store(5 + 4 * stride, makeEntry(5, 2, Bound::EXACT));
+
+    TTEntry entry;
+    EXPECT_FALSE(table.probe(5, entry));
+    for (uint64_t i = 1; i <= 4; i++) {
+        EXPECT_TRUE(table.probe(5 + i * stride, entry));
+    }
+}
+
+TEST(TranspositionTableTest, ConcurrentAccessNeverReturnsTornEntries) {
+    TranspositionTable table(1);
+    std::atomic<bool> torn(false);
+
+    // Every writer stores an entry derived from its key, so any mix of two
+    // writes would show up as a mismatch.
+    auto worker = [&table, &torn](uint64_t seed) {
+        TTEntry entry;
+        for (uint64_t i = 0; i < 200000; i++) {
+            uint64_t key = ((i * 2654435761ULL + seed) % 4096) * 0x9E3779B97F4A7C15ULL;
+            if (table.probe(key, entry) && entry.score != static_cast<int>(key >> 40)) {
+                torn = true;
+            }
+            table.store(key, makeEntry(static_cast<int>(key >> 40), static_cast<int>(i % 32), Bound::EXACT));
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (uint64_t t = 0; t < 4; t++) {
+        threads.emplace_back(worker, t);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_FALSE(torn);
+}
+
+TEST(TranspositionTableTest, SearchReusesTableAcrossRuns) {
+    Board board;
+    board.setupStandardPosition();
+    TranspositionTable table(4);
+
+    SearchLimits limits;
+    limits.max_depth = 3;
+
+    Search first(PlayerColor::WHITE, 10, 10, &table);
+    SearchResult cold = first.run(board, limits);
+    EXPECT_GT(cold.tt_probes, 0u);
+
+    table.newSearch();
+    Search second(PlayerColor::WHITE, 10, 10, &table);
+    SearchResult warm = second.run(board, limits);
+
+    EXPECT_LT(warm.nodes, cold.nodes);
+    EXPECT_GT(warm.tt_hits, 0u);
+    EXPECT_EQ(cold.tt_probes + warm.tt_probes, table.stats().probes);
+    EXPECT_GT(table.stats().hitRate(), 0.0);
+}
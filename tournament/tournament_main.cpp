@@ -0,0 +1,241 @@
+#include "../bot/tournament.h"
+#include "../utility/fen_parser.h"
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace {
+
+void printUsage() {
+    std::cout << "Usage: SpeedChessTournament [options]\n"
+              << "  --first SPEC          first player, e.g. difficulty=hard,engine=alpha-beta\n"
+              << "  --second SPEC         second player (same keys: name, difficulty, engine,\n"
+              << "                        threads, hash, movetime, reaction, network)\n"
+              << "  --games N             games to play (default 100)\n"
+              << "  --concurrency N       games run in parallel (default: hardware threads)\n"
+              << "  --openings FILE       one FEN per line (default: standard position)\n"
+              << "  --cooldown TICKS      cooldown for both sides (default 10)\n"
+              << "  --white-cooldown T    cooldown for White\n"
+              << "  --black-cooldown T    cooldown for Black\n"
+              << "  --max-ticks N         unfinished games are drawn after N ticks (default 3000)\n"
+              << "  --sprt ELO0,ELO1      SPRT hypotheses (default 0,10), alpha = beta = 0.05\n"
+              << "  --stop-on-sprt        stop once the SPRT has decided\n"
+              << "  --games-out FILE      per-game results as CSV\n"
+              << "  --moves-out FILE      per-move timings as CSV\n";
+}
+
+const char* resultName(GameResult result) {
+    switch (result) {
+        case GameResult::WHITE_WIN:
+            return "1-0";
+        case GameResult::BLACK_WIN:
+            return "0-1";
+        default:
+            return "1/2-1/2";
+    }
+}
+
+const char* decisionName(SprtDecision decision) {
+    switch (decision) {
+        case SprtDecision::ACCEPT_H1:
+            return "H1 accepted";
+        case SprtDecision::ACCEPT_H0:
+            return "H0 accepted";
+        default:
+            return "continue";
+    }
+}
+
+bool readOpenings(const std::string& path, std::vector<std::string>& openings) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    openings.clear();
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        if (line != "standard" && !FENParser::isValidFEN(line)) {
+            std::cerr << "Skipping invalid FEN: " << line << std::endl;
+            continue;
+        }
+        openings.push_back(line);
+    }
+    return !openings.empty();
+}
+
+bool readInt(const char* text, int& value) {
+    try {
+        value = std::stoi(text);
+    } catch (...) {
+        return false;
+    }
+    return value >= 0;
+}
+
+// Mean and maximum think time of `name`'s moves, in milliseconds.
+void reportMoveTimes(const std::vector<GameRecord>& records, bool first, const std::string& name) {
+    double total_ms = 0;
+    double max_ms = 0;
+    uint64_t nodes = 0;
+    int moves = 0;
+    for (const auto& record : records) {
+        PlayerColor color = record.first_is_white == first ? PlayerColor::WHITE : PlayerColor::BLACK;
+        for (const auto& move : record.moves) {
+            if (move.side != color) {
+                continue;
+            }
+            double ms = move.think_time.count() / 1000.0;
+            total_ms += ms;
+            max_ms = std::max(max_ms, ms);
+            nodes += move.nodes;
+            moves++;
+        }
+    }
+    std::cout << "  " << std::left << std::setw(12) << name << std::right
+              << " moves " << moves
+              << ", mean " << std::fixed << std::setprecision(2) << (moves ? total_ms / moves : 0.0) << " ms"
+              << ", max " << max_ms << " ms"
+              << ", nodes/move " << std::setprecision(0) << (moves ? static_cast<double>(nodes) / moves : 0.0)
+              << std::endl;
+}
+
+}
+
+int main(int argc, char** argv) {
+    PlayerConfig first;
+    first.name = "first";
+    PlayerConfig second;
+    second.name = "second";
+    TournamentOptions options;
+    options.concurrency = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::string games_out;
+    std::string moves_out;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        int number = 0;
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        } else if (arg == "--stop-on-sprt") {
+            options.stop_on_sprt = true;
+        } else if (!has_value) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            printUsage();
+            return 1;
+        } else if (arg == "--first" || arg == "--second") {
+            PlayerConfig& config = arg == "--first" ? first : second;
+            if (!parsePlayerConfig(argv[++i], config)) {
+                std::cerr << "Invalid player spec: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--openings") {
+            if (!readOpenings(argv[++i], options.openings)) {
+                std::cerr << "No usable openings in " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--sprt") {
+            std::string bounds = argv[++i];
+            size_t comma = bounds.find(',');
+            if (comma == std::string::npos) {
+                std::cerr << "Expected ELO0,ELO1: " << bounds << std::endl;
+                return 1;
+            }
+            options.elo0 = std::atof(bounds.substr(0, comma).c_str());
+            options.elo1 = std::atof(bounds.substr(comma + 1).c_str());
+        } else if (arg == "--games-out") {
+            games_out = argv[++i];
+        } else if (arg == "--moves-out") {
+            moves_out = argv[++i];
+        } else if (readInt(argv[i + 1], number)) {
+            i++;
+            if (arg == "--games") {
+                options.games = number;
+            } else if (arg == "--concurrency") {
+                options.concurrency = std::max(1, number);
+            } else if (arg == "--cooldown") {
+                options.white_cooldown = number;
+                options.black_cooldown = number;
+            } else if (arg == "--white-cooldown") {
+                options.white_cooldown = number;
+            } else if (arg == "--black-cooldown") {
+                options.black_cooldown = number;
+            } else if (arg == "--max-ticks") {
+                options.max_ticks = number;
+            } else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                printUsage();
+                return 1;
+            }
+        } else {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i + 1] << std::endl;
+            return 1;
+        }
+    }
+
+    std::ofstream games_file;
+    if (!games_out.empty()) {
+        games_file.open(games_out);
+        games_file << "game,opening,white,black,result,ticks,moves,wall_ms\n";
+    }
+    std::ofstream moves_file;
+    if (!moves_out.empty()) {
+        moves_file.open(moves_out);
+        moves_file << "game,tick,side,player,piece,from_row,from_col,to_row,to_col,think_us,nodes,depth\n";
+    }
+
+    std::cout << first.name << " vs " << second.name << ": " << options.games << " games on "
+              << options.concurrency << " threads" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    auto records = runTournament(options, first, second, [&](const GameRecord& record, const MatchScore& score) {
+        const std::string& white = record.first_is_white ? first.name : second.name;
+        const std::string& black = record.first_is_white ? second.name : first.name;
+        std::cout << "game " << std::setw(5) << record.game_index << "  " << std::left << std::setw(8)
+                  << resultName(record.result) << std::right << "  " << score.wins << "-" << score.losses << "-"
+                  << score.draws << std::endl;
+
+        if (games_file) {
+            games_file << record.game_index << ',' << record.opening_index << ',' << white << ',' << black << ','
+                       << resultName(record.result) << ',' << record.ticks << ',' << record.moves.size() << ','
+                       << record.wall_time.count() / 1000.0 << '\n';
+        }
+        if (moves_file) {
+            for (const auto& move : record.moves) {
+                bool white_moved = move.side == PlayerColor::WHITE;
+                moves_file << record.game_index << ',' << move.tick << ',' << (white_moved ? "white" : "black")
+                           << ',' << (white_moved ? white : black) << ',' << move.move.piece_id << ','
+                           << move.move.from.row << ',' << move.move.from.col << ',' << move.move.to.row << ','
+                           << move.move.to.col << ',' << move.think_time.count() << ',' << move.nodes << ','
+                           << move.depth << '\n';
+            }
+        }
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    MatchScore score;
+    for (const auto& record : records) {
+        score.add(record.result, record.first_is_white);
+    }
+    EloEstimate elo = estimateElo(score);
+    SprtResult test = sprt(score, options.elo0, options.elo1, options.alpha, options.beta);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "\nGames: " << score.games() << " in " << seconds << " s ("
+              << std::setprecision(2) << score.games() / seconds << " games/s)\n"
+              << first.name << " W-L-D: " << score.wins << "-" << score.losses << "-" << score.draws
+              << std::setprecision(1) << "  score " << score.score() * 100.0 << "%\n"
+              << "Elo: " << elo.elo << "  95% CI [" << elo.lower << ", " << elo.upper << "]\n"
+              << "SPRT(" << options.elo0 << ", " << options.elo1 << "): LLR " << std::setprecision(2) << test.llr
+              << " [" << test.lower_bound << ", " << test.upper_bound << "]  " << decisionName(test.decision)
+              << "\nThink time:" << std::endl;
+    reportMoveTimes(records, true, first.name);
+    reportMoveTimes(records, false, second.name);
+    return 0;
+}
@@ -20,9 +20,10 @@ GameUI::GameUI(Game &game, GameSettings settings, unsigned width, unsigned heigh
 
     if (settings.against_ai) {
         if (settings.ai_difficulty.has_value()) {
-            ai_player_ = std::make_unique<AIPlayer>(settings.ai_difficulty.value(), PlayerColor::BLACK);
+            ai_worker_ = std::make_unique<AIWorker>(settings.ai_difficulty.value(), PlayerColor::BLACK,
+                                                    settings.ai_engine);
         } else {
-            ai_player_ = std::make_unique<AIPlayer>(AIDifficulty::MEDIUM, PlayerColor::BLACK);
+            ai_worker_ = std::make_unique<AIWorker>(AIDifficulty::MEDIUM, PlayerColor::BLACK, settings.ai_engine);
         }
     }
 
@@ -137,12 +138,12 @@ void GameUI::update() {
 
 
     static sf::Clock ai_clock;
-    if (state_ == UIState::GAME_ACTIVE && against_ai_ && ai_player_ &&
+    if (state_ == UIState::GAME_ACTIVE && against_ai_ && ai_worker_ &&
         game_.getState() == GameState::ACTIVE) {
 
 
         static float delay = 4.0f;
-        switch (ai_player_->getDifficulty()) {
+        switch (ai_worker_->getDifficulty()) {
             case AIDifficulty::EASY:
                 delay = 7.0f;
                 break;
@@ -160,12 +161,21 @@ void GameUI::update() {
                 break;
         }
 
-        if (ai_clock.getElapsedTime().asSeconds() >= delay) {
-            auto move = ai_player_->getBestMove(game_);
-            if (move) {
-                game_.makeMove(move->piece_id, move->to);
-            }
+        // The search runs on the worker thread; a frame only drains results.
+        ai_worker_->cancelIfStale(game_);
+        while (auto result = ai_worker_->poll()) {
+            ai_worker_->apply(game_, *result);
+        }
+
+        float elapsed = ai_clock.getElapsedTime().asSeconds();
+        if (elapsed >= delay && !ai_worker_->busy()) {
+            ai_worker_->request(game_);
             ai_clock.restart();
+        } else if (!ai_worker_->busy()) {
+            // Use the enforced wait to search the position we will be asked about.
+            auto remaining = std::chrono::duration<float>(delay - elapsed);
+            ai_worker_->ponder(game_, std::chrono::steady_clock::now() +
+                                      std::chrono::duration_cast<std::chrono::steady_clock::duration>(remaining));
         }
     }
 }
@@ -279,21 +289,21 @@ void GameUI::drawBoard() {
 
 void GameUI::drawPieces() {
 
-    auto pieces = game_.getBoard().getAllPieces(false);
+    Game::SnapshotRef snapshot = game_.snapshot();
 
 
-    for (const auto &piece: pieces) {
+    snapshot->forEachPiece([this](const Piece& piece) {
 
         if (is_dragging_ && selected_piece_id_.has_value() && piece.id == selected_piece_id_.value()) {
-            continue;
+            return;
         }
 
         drawPieceWithCooldown(piece);
-    }
+    });
 
 
     if (is_dragging_ && selected_piece_id_.has_value()) {
-        auto piece_opt = game_.getBoard().getPieceById(selected_piece_id_.value());
+        auto piece_opt = snapshot->pieceById(selected_piece_id_.value());
         if (piece_opt) {
             std::string key = getPieceKey(piece_opt->type, piece_opt->color);
 
@@ -349,7 +359,8 @@ void GameUI::drawPieceWithCooldown(const Piece &piece) {
             }
 
 
-            float percent = static_cast<float>(piece.cooldown_ticks_remaining) / cooldown;
+            float remaining_ms = std::chrono::duration<float, std::milli>(game_.cooldownRemaining(piece.id)).count();
+            float percent = remaining_ms / (cooldown * game_.getTickRate());
 
 
             sf::CircleShape cooldown_shape(square_size_ / 2);
@@ -369,7 +380,7 @@ void GameUI::drawPieceWithCooldown(const Piece &piece) {
 
 
             std::ostringstream ss;
-            ss << std::fixed << std::setprecision(1) << static_cast<float>(piece.cooldown_ticks_remaining) / 10.0;
+            ss << std::fixed << std::setprecision(1) << remaining_ms / 1000.0f;
             sf::Text cooldown_text(ss.str(), font_, 20);
             cooldown_text.setFillColor(sf::Color::White);
             cooldown_text.setOutlineColor(sf::Color::Black);
@@ -474,7 +485,7 @@ void GameUI::handleMouseButtonPressed(int x, int y) {
     if (board_pos.row == -1) return;
 
 
-    auto piece = game_.getBoard().getPieceAt(board_pos);
+    auto piece = game_.snapshot()->pieceAt(board_pos);
     if (piece) {
 
         if (against_ai_ && piece->color == PlayerColor::BLACK) {
@@ -1,7 +1,7 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include "../core/game.h"
-#include "../bot/ai_player.h"
+#include "../bot/ai_worker.h"
 
 enum class UIState {
     GAME_ACTIVE,
@@ -17,7 +17,7 @@ private:
     sf::RenderWindow window_;
     UIState state_;
     Game& game_;
-    std::unique_ptr<AIPlayer> ai_player_;
+    std::unique_ptr<AIWorker> ai_worker_;
     bool against_ai_;
 
     sf::Font font_;
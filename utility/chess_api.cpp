@@ -30,7 +30,7 @@ bool ChessAPI::makeMove(int fromRow, int fromCol, int toRow, int toCol) {
         return false;
     }
 
-    auto piece = game_.getBoard().getPieceAt({fromRow, fromCol});
+    auto piece = game_.snapshot()->pieceAt({fromRow, fromCol});
     if (!piece) {
         return false;
     }
@@ -42,17 +42,17 @@ std::optional<Piece> ChessAPI::getPieceAt(int row, int col) const {
     if (row < 0 || row > 7 || col < 0 || col > 7) {
         return std::nullopt;
     }
-    return game_.getBoard().getPieceAt({row, col});
+    return game_.snapshot()->pieceAt({row, col});
 }
 
 void ChessAPI::printBoard() const {
-    const Board& board = game_.getBoard();
+    Game::SnapshotRef snapshot = game_.snapshot();
 
     std::cout << "  +------------------------+\n";
     for (int row = 7; row >= 0; --row) {
         std::cout << (row + 1) << " | ";
         for (int col = 0; col < 8; ++col) {
-            auto piece = board.getPieceAt({row, col});
+            auto piece = snapshot->pieceAt({row, col});
             char symbol = '.';
 
             if (piece) {
@@ -0,0 +1,76 @@
+#include "clock_source.h"
+#include <algorithm>
+
+ManualClock::ManualClock()
+        : tick_rate_ms_(100), running_(false), ticks_(0), now_(Time::zero()), wake_(kNever) {
+}
+
+void ManualClock::setTickRate(int milliseconds) {
+    tick_rate_ms_ = milliseconds;
+}
+
+void ManualClock::start(std::function<void()> callback) {
+    callback_ = std::move(callback);
+    running_ = true;
+}
+
+void ManualClock::stop() {
+    running_ = false;
+}
+
+void ManualClock::wakeAt(Time when) {
+    wake_ = when;
+}
+
+int ManualClock::advance(int ticks) {
+    int advanced = 0;
+    while (advanced < ticks && running_) {
+        advanceBy(std::chrono::milliseconds(tick_rate_ms_));
+        ticks_++;
+        advanced++;
+    }
+    return advanced;
+}
+
+bool ManualClock::advanceBy(Time duration) {
+    if (!running_) {
+        return false;
+    }
+    Time target = now_ + duration;
+    while (wake_ <= target) {
+        now_ = std::max(now_, wake_);
+        wake_ = kNever;
+        callback_();
+        if (!running_) {
+            return false;
+        }
+    }
+    now_ = target;
+    return true;
+}
+
+// steady_clock counts from before the process started, so a running
+// origin, the start instant minus the time banked since, is never
+// negative and fits the word next to the flag.
+void SteadyGameTime::start() {
+    Time origin = sinceEpoch(SteadyClock::now()) - now();
+    word_.store(static_cast<uint64_t>(origin.count()) << 1 | 1, std::memory_order_release);
+}
+
+void SteadyGameTime::stop() {
+    word_.store(static_cast<uint64_t>(now().count()) << 1, std::memory_order_release);
+}
+
+ClockSource::Time SteadyGameTime::now() const {
+    uint64_t word = word_.load(std::memory_order_acquire);
+    Time value(static_cast<int64_t>(word >> 1));
+    if (!(word & 1)) {
+        return value;
+    }
+    return sinceEpoch(SteadyClock::now()) - value;
+}
+
+SteadyGameTime::SteadyClock::time_point SteadyGameTime::when(Time time) const {
+    Time origin(static_cast<int64_t>(word_.load(std::memory_order_acquire) >> 1));
+    return SteadyClock::time_point(std::chrono::duration_cast<SteadyClock::duration>(origin + time));
+}
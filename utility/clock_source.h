@@ -0,0 +1,102 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+// Game time for Game. Time only runs between start() and stop(), so a
+// paused game's cooldowns are frozen too. Rather than ticking, a source
+// calls `callback` once when game time reaches the wake-up time last asked
+// for with wakeAt(), so an idle game costs nothing. Once stop() returns no
+// callback is running any more. A source may be restarted after stop().
+//
+// The tick rate is the length of one cooldown tick, the unit cooldowns are
+// configured in.
+class ClockSource {
+public:
+    using Time = std::chrono::microseconds;
+    static constexpr Time kNever = Time::max();
+
+    virtual ~ClockSource() = default;
+
+    virtual void setTickRate(int milliseconds) = 0;
+    virtual int tickRate() const = 0;
+    virtual void start(std::function<void()> callback) = 0;
+    virtual void stop() = 0;
+
+    // Game time elapsed while running. Called by Game's readers, so it
+    // should not take locks a firing callback may hold.
+    virtual Time now() const = 0;
+    // Replaces the pending wake-up; kNever cancels it. A time already
+    // reached wakes as soon as possible.
+    virtual void wakeAt(Time when) = 0;
+};
+
+// Game time of a steady_clock-driven source, readable from any thread
+// without a lock. One atomic word holds either the time banked while
+// stopped or, while running, the steady_clock instant game time counts
+// from; its low bit tells which. start() and stop() must be serialized by
+// the owning clock.
+class SteadyGameTime {
+public:
+    using Time = ClockSource::Time;
+    using SteadyClock = std::chrono::steady_clock;
+
+    SteadyGameTime() : word_(0) {}
+
+    // Runs from now on, carrying on from the banked time.
+    void start();
+    // Banks the time reached so far and freezes it.
+    void stop();
+    bool running() const { return word_.load(std::memory_order_acquire) & 1; }
+    Time now() const;
+    // The instant game time reaches `time`; only meaningful while running.
+    // now() at or after that instant reads at least `time`.
+    SteadyClock::time_point when(Time time) const;
+
+private:
+    static Time sinceEpoch(SteadyClock::time_point point) {
+        return std::chrono::duration_cast<Time>(point.time_since_epoch());
+    }
+
+    std::atomic<uint64_t> word_;
+};
+
+// Virtual clock for simulations, tests and replays: time only moves when
+// the owner calls advance(), which runs any wake-ups it passes synchronously
+// on the calling thread, each at its exact time. No threads, no sleeping,
+// and the same inputs always give the same game.
+class ManualClock : public ClockSource {
+public:
+    ManualClock();
+
+    void setTickRate(int milliseconds) override;
+    int tickRate() const override { return tick_rate_ms_; }
+    void start(std::function<void()> callback) override;
+    void stop() override;
+    Time now() const override { return now_; }
+    void wakeAt(Time when) override;
+
+    // Moves time forward by `ticks` whole ticks, stopping after the tick in
+    // which the callback stops the clock. Returns the number of ticks
+    // advanced. Does nothing while stopped.
+    int advance(int ticks = 1);
+    // Moves time forward by `duration`, stopping early at a wake-up that
+    // stops the clock. Returns false if it stopped early or was not running.
+    bool advanceBy(Time duration);
+
+    bool running() const { return running_; }
+    Time wakeTime() const { return wake_; }
+    // Whole ticks advanced since construction, and the simulated time they
+    // span.
+    uint64_t ticks() const { return ticks_; }
+    uint64_t elapsedMs() const { return ticks_ * static_cast<uint64_t>(tick_rate_ms_); }
+
+private:
+    std::function<void()> callback_;
+    int tick_rate_ms_;
+    bool running_;
+    uint64_t ticks_;
+    Time now_;
+    Time wake_;
+};
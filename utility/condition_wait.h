@@ -0,0 +1,20 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+// Blocks on `cv` until `ready()` holds; the same contract as
+// cv.wait(lock, ready).
+//
+// From GCC 12 on, condition_variable::wait() binds to a GLIBCXX_3.4.30
+// symbol, and a binary that picks up an older libstdc++ at runtime (say,
+// through a prebuilt gtest's RUNPATH) then refuses to load. Waiting in
+// bounded slices keeps to inline code without handing wait_until() a
+// time_point::max() deadline, which can overflow into the past when the
+// condition variable converts it to its own clock.
+template <typename Predicate>
+void blockUntil(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, Predicate ready) {
+    while (!ready()) {
+        cv.wait_for(lock, std::chrono::hours(1));
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <utility>
+
+// Unbounded lock-free queue for many producers and one consumer (Vyukov's
+// intrusive MPSC design). push() is a single atomic exchange plus a store
+// and never waits for other producers or the consumer. The consumer side,
+// pop(), must only ever run on one thread at a time.
+//
+// A push is visible to pop() once its node is linked; between the exchange
+// and the link a concurrent pop() may briefly report the queue empty even
+// though later pushes already succeeded.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : head_(new Node()), tail_(head_.load(std::memory_order_relaxed)) {
+    }
+
+    ~MpscQueue() {
+        while (Node* node = tail_) {
+            tail_ = node->next.load(std::memory_order_relaxed);
+            delete node;
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        Node* node = new Node(std::move(value));
+        Node* prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    // Consumer only. False when nothing is linked yet.
+    bool pop(T& value) {
+        Node* next = tail_->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        // `next` becomes the new stub; its value moves out and the old stub goes.
+        value = std::move(next->value);
+        delete tail_;
+        tail_ = next;
+        return true;
+    }
+
+private:
+    struct Node {
+        Node() : next(nullptr) {}
+        explicit Node(T v) : next(nullptr), value(std::move(v)) {}
+
+        std::atomic<Node*> next;
+        T value;
+    };
+
+    // Producers swap themselves in at the head; the consumer owns the tail.
+    std::atomic<Node*> head_;
+    Node* tail_;
+};
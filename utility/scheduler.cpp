@@ -0,0 +1,221 @@
+#include "scheduler.h"
+#include "condition_wait.h"
+#include <algorithm>
+
+namespace {
+
+constexpr int kShardShift = TimingWheel::kHandleBits;
+constexpr uint64_t kHandleMask = (uint64_t(1) << kShardShift) - 1;
+
+}
+
+Scheduler& Scheduler::shared() {
+    static Scheduler scheduler(std::clamp(static_cast<int>(std::thread::hardware_concurrency()), 1, 4));
+    return scheduler;
+}
+
+Scheduler::Scheduler(int threads, std::chrono::microseconds resolution)
+        : origin_(Clock::now()),
+          resolution_(std::max(resolution, std::chrono::microseconds(1))),
+          next_shard_(0),
+          running_(true) {
+    threads = std::clamp(threads, 1, 255);
+    for (int i = 0; i < threads; i++) {
+        shards_.push_back(std::make_unique<Shard>());
+    }
+    for (auto& shard : shards_) {
+        shard->thread = std::thread(&Scheduler::shardLoop, this, std::ref(*shard));
+    }
+}
+
+Scheduler::~Scheduler() {
+    running_ = false;
+    for (auto& shard : shards_) {
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+        }
+        shard->wake.notify_all();
+    }
+    for (auto& shard : shards_) {
+        shard->thread.join();
+    }
+}
+
+Scheduler::TimerId Scheduler::schedule(Clock::time_point when, std::function<void()> callback) {
+    uint32_t index = next_shard_++ % shards_.size();
+    Shard& shard = *shards_[index];
+    TimingWheel::Tick tick = tickAt(when);
+    TimingWheel::Handle handle;
+    bool earlier;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        handle = shard.wheel.insert(tick, std::move(callback));
+        earlier = tick < shard.sleep_tick;
+        if (earlier) {
+            shard.sleep_tick = tick;
+        }
+    }
+    if (earlier) {
+        shard.wake.notify_one();
+    }
+    return (TimerId(index) << kShardShift) | handle;
+}
+
+bool Scheduler::cancel(TimerId id) {
+    size_t index = id >> kShardShift;
+    if (id == 0 || index >= shards_.size()) {
+        return false;
+    }
+    Shard& shard = *shards_[index];
+    TimingWheel::Handle handle = id & kHandleMask;
+    std::function<void()> dropped;
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.wheel.cancel(handle)) {
+        return true;
+    }
+    for (size_t i = shard.firing_next; i < shard.firing.size(); i++) {
+        if (shard.firing[i].handle == handle && shard.firing[i].callback) {
+            dropped = std::move(shard.firing[i].callback);
+            shard.firing[i].callback = nullptr;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t Scheduler::pending() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total += shard->wheel.size() + (shard->firing.size() - shard->firing_next);
+    }
+    return total;
+}
+
+TimingWheel::Tick Scheduler::tickAt(Clock::time_point time) const {
+    if (time <= origin_) {
+        return 0;
+    }
+    auto offset = std::chrono::duration_cast<std::chrono::nanoseconds>(time - origin_);
+    auto step = std::chrono::duration_cast<std::chrono::nanoseconds>(resolution_);
+    return static_cast<TimingWheel::Tick>((offset + step - std::chrono::nanoseconds(1)) / step);
+}
+
+Scheduler::Clock::time_point Scheduler::timeAt(TimingWheel::Tick tick) const {
+    return origin_ + tick * resolution_;
+}
+
+void Scheduler::shardLoop(Shard& shard) {
+    std::unique_lock<std::mutex> lock(shard.mutex);
+    while (running_) {
+        TimingWheel::Tick next = shard.wheel.nextEventTick();
+        shard.sleep_tick = next;
+        auto woken = [&] { return !running_ || shard.sleep_tick != next; };
+        if (next == TimingWheel::kNoTick) {
+            blockUntil(shard.wake, lock, woken);
+        } else {
+            shard.wake.wait_until(lock, timeAt(next), woken);
+        }
+        if (!running_) {
+            return;
+        }
+
+        // Every tick that has fully started is due.
+        auto elapsed = Clock::now() - origin_;
+        shard.wheel.advance(static_cast<TimingWheel::Tick>(elapsed / resolution_), shard.firing);
+
+        for (shard.firing_next = 0; shard.firing_next < shard.firing.size();) {
+            TimingWheel::Expired& entry = shard.firing[shard.firing_next++];
+            if (!entry.callback) {
+                continue;
+            }
+            std::function<void()> callback = std::move(entry.callback);
+            entry.callback = nullptr;
+            lock.unlock();
+            callback();
+            callback = nullptr;
+            lock.lock();
+        }
+        shard.firing.clear();
+        shard.firing_next = 0;
+    }
+}
+
+SchedulerClock::SchedulerClock(Scheduler& scheduler)
+        : scheduler_(scheduler), state_(std::make_shared<State>()) {
+}
+
+SchedulerClock::~SchedulerClock() {
+    stop();
+}
+
+void SchedulerClock::setTickRate(int milliseconds) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->tick_rate_ms = milliseconds;
+}
+
+int SchedulerClock::tickRate() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->tick_rate_ms;
+}
+
+void SchedulerClock::start(std::function<void()> callback) {
+    stop();
+
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->callback = std::move(callback);
+    state_->time.start();
+    arm(*state_);
+}
+
+void SchedulerClock::stop() {
+    std::unique_lock<std::mutex> lock(state_->mutex);
+    state_->time.stop();
+    scheduler_.cancel(state_->timer);
+    state_->timer = 0;
+    if (state_->firing_thread != std::this_thread::get_id()) {
+        blockUntil(state_->idle, lock, [this] { return !state_->firing; });
+    }
+}
+
+// Lock-free, so readers never queue behind a firing callback.
+ClockSource::Time SchedulerClock::now() const {
+    return state_->time.now();
+}
+
+void SchedulerClock::wakeAt(Time when) {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->wake = when;
+    arm(*state_);
+}
+
+void SchedulerClock::arm(State& state) {
+    scheduler_.cancel(state.timer);
+    state.timer = 0;
+    if (state.time.running() && state.wake != kNever) {
+        auto at = state.time.when(state.wake);
+        Time when = state.wake;
+        std::shared_ptr<State> shared = state_;
+        state.timer = scheduler_.schedule(at, [shared, when]() { fire(shared, when); });
+    }
+}
+
+void SchedulerClock::fire(const std::shared_ptr<State>& state, Time when) {
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->time.running() || state->wake != when) {
+            return;
+        }
+        state->wake = kNever;
+        state->timer = 0;
+        state->firing = true;
+        state->firing_thread = std::this_thread::get_id();
+    }
+    state->callback();
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->firing = false;
+    state->firing_thread = std::thread::id();
+    state->idle.notify_all();
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include "clock_source.h"
+#include "timing_wheel.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// One-shot timers for any number of games on a small fixed set of threads.
+// Each thread owns a TimingWheel shard and sleeps until its next expiry;
+// timers are spread over the shards round-robin and run on their shard's
+// thread, in expiry order. Timers fire at their time rounded up to the
+// resolution, never early.
+class Scheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    // Shard in the top byte, the shard's wheel handle below; never 0.
+    using TimerId = uint64_t;
+
+    // The process-wide instance, with one thread per hardware thread up to 4.
+    static Scheduler& shared();
+
+    explicit Scheduler(int threads = 1, std::chrono::microseconds resolution = std::chrono::milliseconds(1));
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    TimerId schedule(Clock::time_point when, std::function<void()> callback);
+    // True if the timer was pending and now never runs. Does not wait for a
+    // callback that is already running.
+    bool cancel(TimerId id);
+
+    int threads() const { return static_cast<int>(shards_.size()); }
+    std::chrono::microseconds resolution() const { return resolution_; }
+    size_t pending() const;
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::condition_variable wake;
+        TimingWheel wheel;
+        // Tick the thread sleeps until; an earlier insert wakes it.
+        TimingWheel::Tick sleep_tick = TimingWheel::kNoTick;
+        // Fired timers, run from `firing_next` on.
+        std::vector<TimingWheel::Expired> firing;
+        size_t firing_next = 0;
+        std::thread thread;
+    };
+
+    void shardLoop(Shard& shard);
+    TimingWheel::Tick tickAt(Clock::time_point time) const;
+    Clock::time_point timeAt(TimingWheel::Tick tick) const;
+
+    Clock::time_point origin_;
+    std::chrono::microseconds resolution_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<uint32_t> next_shard_;
+    std::atomic<bool> running_;
+};
+
+// ClockSource on a Scheduler: no thread of its own, so any number of games
+// can share a few threads. Game time follows steady_clock while running.
+// Timers hold the clock's state rather than the clock, so one that fires
+// while the clock is stopped or destroyed finds it stopped and returns.
+class SchedulerClock : public ClockSource {
+public:
+    explicit SchedulerClock(Scheduler& scheduler = Scheduler::shared());
+    ~SchedulerClock() override;
+
+    void setTickRate(int milliseconds) override;
+    int tickRate() const override;
+    void start(std::function<void()> callback) override;
+    void stop() override;
+    Time now() const override;
+    void wakeAt(Time when) override;
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable idle;
+        std::function<void()> callback;
+        int tick_rate_ms = 100;
+        // Also tells whether the clock runs.
+        SteadyGameTime time;
+        // Kept across stop() and re-armed by start().
+        Time wake = kNever;
+        Scheduler::TimerId timer = 0;
+        // Set while `callback` runs, on `firing_thread`.
+        bool firing = false;
+        std::thread::id firing_thread;
+    };
+
+    static void fire(const std::shared_ptr<State>& state, Time when);
+    void arm(State& state);
+
+    Scheduler& scheduler_;
+    std::shared_ptr<State> state_;
+};
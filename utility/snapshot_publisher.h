@@ -0,0 +1,181 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+// RCU-style publication of immutable values for one writer and any number
+// of readers. The writer fills a spare slot and swaps it in with one atomic
+// exchange; a reader takes the current value with a single fetch_add and
+// gives it back with a fetch_sub, never retrying and never waiting, and the
+// value it holds stays untouched until it lets go.
+//
+// The current slot and the number of times it was taken share one word
+// (split reference count). Retiring a slot hands that count over to the
+// slot, and whichever of the writer and the last reader brings the slot's
+// balance to zero marks it free for reuse. Slots are never deallocated
+// while the publisher lives, so a reader can always dereference the index
+// it got; the pool only grows when every spare slot is still being read.
+//
+// prepare() and publish() must not run on two threads at once. A Ref must
+// not outlive its publisher.
+template <typename T>
+class SnapshotPublisher {
+    struct Slot;
+
+public:
+    class Ref {
+    public:
+        Ref() : slot_(nullptr) {}
+        Ref(Ref&& other) noexcept : slot_(other.slot_) { other.slot_ = nullptr; }
+        Ref& operator=(Ref&& other) noexcept {
+            if (this != &other) {
+                release();
+                slot_ = other.slot_;
+                other.slot_ = nullptr;
+            }
+            return *this;
+        }
+        ~Ref() { release(); }
+
+        Ref(const Ref&) = delete;
+        Ref& operator=(const Ref&) = delete;
+
+        const T& operator*() const { return slot_->value; }
+        const T* operator->() const { return &slot_->value; }
+        const T* get() const { return slot_ ? &slot_->value : nullptr; }
+
+    private:
+        friend class SnapshotPublisher;
+        explicit Ref(Slot* slot) : slot_(slot) {}
+
+        void release() {
+            if (slot_ && slot_->balance.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                slot_->free.store(true, std::memory_order_release);
+            }
+            slot_ = nullptr;
+        }
+
+        Slot* slot_;
+    };
+
+    // Starts out publishing a default-constructed T.
+    SnapshotPublisher() : slot_count_(0), cursor_(0), prepared_(kNoSlot) {
+        for (auto& chunk : chunks_) {
+            chunk.store(nullptr, std::memory_order_relaxed);
+        }
+        uint32_t first = grow();
+        slotAt(first).free.store(false, std::memory_order_relaxed);
+        current_.store(first, std::memory_order_release);
+    }
+
+    ~SnapshotPublisher() {
+        for (int chunk = 0; chunk < kMaxChunks; chunk++) {
+            delete[] chunks_[chunk].load(std::memory_order_relaxed);
+        }
+    }
+
+    SnapshotPublisher(const SnapshotPublisher&) = delete;
+    SnapshotPublisher& operator=(const SnapshotPublisher&) = delete;
+
+    // Wait-free: one fetch_add, plus a walk over at most kMaxChunks chunks.
+    Ref acquire() const {
+        uint64_t word = current_.fetch_add(kOneReader, std::memory_order_acquire);
+        return Ref(&slotAt(static_cast<uint32_t>(word & kIndexMask)));
+    }
+
+    // Writer: a slot no reader can see, holding whatever it held last time.
+    T& prepare() {
+        if (prepared_ == kNoSlot) {
+            prepared_ = findFree();
+        }
+        return slotAt(prepared_).value;
+    }
+
+    // Writer: makes the prepared value current and retires the previous one.
+    void publish() {
+        prepare();
+        uint32_t index = prepared_;
+        prepared_ = kNoSlot;
+
+        uint64_t old = current_.exchange(index, std::memory_order_acq_rel);
+        Slot& retired = slotAt(static_cast<uint32_t>(old & kIndexMask));
+        int64_t taken = static_cast<int64_t>(old >> kIndexBits);
+        if (retired.balance.fetch_add(taken, std::memory_order_acq_rel) + taken == 0) {
+            retired.free.store(true, std::memory_order_release);
+        }
+    }
+
+    // Slots allocated so far; grows only while readers hold old values.
+    uint32_t capacity() const { return slot_count_; }
+
+private:
+    static constexpr int kIndexBits = 16;
+    static constexpr uint64_t kIndexMask = (uint64_t(1) << kIndexBits) - 1;
+    static constexpr uint64_t kOneReader = uint64_t(1) << kIndexBits;
+    // Chunk k holds kFirstChunk << k slots; all of them fit the index bits.
+    static constexpr uint32_t kFirstChunk = 4;
+    static constexpr int kMaxChunks = 14;
+    static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+    struct Slot {
+        T value{};
+        // Minus the releases while current; once retired, the takes still
+        // outstanding.
+        std::atomic<int64_t> balance{0};
+        std::atomic<bool> free{true};
+    };
+
+    Slot& slotAt(uint32_t index) const {
+        uint32_t base = 0;
+        int chunk = 0;
+        while (index >= base + (kFirstChunk << chunk)) {
+            base += kFirstChunk << chunk;
+            chunk++;
+        }
+        return chunks_[chunk].load(std::memory_order_acquire)[index - base];
+    }
+
+    uint32_t findFree() {
+        while (true) {
+            for (uint32_t step = 0; step < slot_count_; step++) {
+                uint32_t index = (cursor_ + step) % slot_count_;
+                Slot& slot = slotAt(index);
+                if (slot.free.load(std::memory_order_acquire)) {
+                    cursor_ = index + 1;
+                    slot.free.store(false, std::memory_order_relaxed);
+                    return index;
+                }
+            }
+            uint32_t added = grow();
+            if (added != kNoSlot) {
+                slotAt(added).free.store(false, std::memory_order_relaxed);
+                return added;
+            }
+            // Every one of the 65532 slots is held by some reader.
+            std::this_thread::yield();
+        }
+    }
+
+    // Allocates the next chunk; returns its first slot, or kNoSlot when
+    // every chunk is in use.
+    uint32_t grow() {
+        int chunk = 0;
+        while (chunk < kMaxChunks && chunks_[chunk].load(std::memory_order_relaxed)) {
+            chunk++;
+        }
+        if (chunk == kMaxChunks) {
+            return kNoSlot;
+        }
+        chunks_[chunk].store(new Slot[kFirstChunk << chunk], std::memory_order_release);
+        uint32_t first = slot_count_;
+        slot_count_ += kFirstChunk << chunk;
+        return first;
+    }
+
+    mutable std::atomic<uint64_t> current_;
+    std::atomic<Slot*> chunks_[kMaxChunks];
+    // Writer only.
+    uint32_t slot_count_;
+    uint32_t cursor_;
+    uint32_t prepared_;
+};
@@ -1,48 +1,179 @@
 #include "timer.h"
-#include <iostream>
+#include "condition_wait.h"
+#include <algorithm>
 
-Timer::Timer() : tick_rate_ms_(100), running_(false) {
+Timer::Timer()
+        : tick_rate_ms_(100),
+          shutdown_(false),
+          firing_(false),
+          periodic_(false),
+          policy_(OverrunPolicy::CATCH_UP),
+          wake_(kNever),
+          next_tick_(kNever),
+          generation_(0) {
 }
 
 Timer::~Timer() {
-    stop();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shutdown_ = true;
+        time_.stop();
+        generation_++;
+    }
+    wake_cv_.notify_one();
+    if (timer_thread_.joinable()) {
+        timer_thread_.join();
+    }
 }
 
 void Timer::setTickRate(int milliseconds) {
-    tick_rate_ms_ = milliseconds;
+    std::lock_guard<std::mutex> lock(mutex_);
+    tick_rate_ms_ = std::max(1, milliseconds);
+}
+
+int Timer::tickRate() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return tick_rate_ms_;
 }
 
 void Timer::start(std::function<void()> callback) {
-    if (running_) {
-        stop();
+    std::unique_lock<std::mutex> lock(mutex_);
+    time_.stop();
+    if (timer_thread_.get_id() != std::this_thread::get_id()) {
+        blockUntil(idle_cv_, lock, [this] { return !firing_; });
     }
 
-    running_ = true;
-    timer_thread_ = std::thread(&Timer::timerLoop, this, callback);
+    callback_ = std::move(callback);
+    time_.start();
+    generation_++;
+    if (!timer_thread_.joinable()) {
+        timer_thread_ = std::thread(&Timer::timerLoop, this);
+    }
+    lock.unlock();
+    wake_cv_.notify_one();
 }
 
 void Timer::stop() {
-    if (running_) {
-        running_ = false;
-        if (timer_thread_.joinable()) {
-            timer_thread_.join();
-        }
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (time_.running()) {
+        time_.stop();
+        generation_++;
+        wake_cv_.notify_one();
+    }
+    // A callback stopping its own clock must not wait for itself.
+    if (timer_thread_.get_id() != std::this_thread::get_id()) {
+        blockUntil(idle_cv_, lock, [this] { return !firing_; });
     }
 }
 
-void Timer::timerLoop(std::function<void()> callback) {
-    while (running_) {
-        auto start = std::chrono::steady_clock::now();
+// Lock-free, so readers never queue behind a firing callback.
+ClockSource::Time Timer::now() const {
+    return time_.now();
+}
+
+void Timer::wakeAt(Time when) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wake_ = when;
+        generation_++;
+    }
+    wake_cv_.notify_one();
+}
+
+void Timer::setPeriodic(bool periodic, OverrunPolicy policy) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        periodic_ = periodic;
+        policy_ = policy;
+        // The next whole tick of game time.
+        next_tick_ = (time_.now() / tickLength() + 1) * tickLength();
+        generation_++;
+    }
+    wake_cv_.notify_one();
+}
 
-        callback();
+Timer::Stats Timer::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
 
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::steady_clock::now() - start).count();
+void Timer::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_ = Stats();
+}
 
-        int sleep_time = tick_rate_ms_ - static_cast<int>(elapsed);
-        if (sleep_time > 0) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(sleep_time));
+ClockSource::Time Timer::Stats::percentile(double fraction) const {
+    uint64_t target = static_cast<uint64_t>(fraction * callbacks);
+    uint64_t seen = 0;
+    for (int i = 0; i < kBuckets; i++) {
+        seen += lateness[i];
+        if (seen > target) {
+            return i == kBuckets - 1 ? max_lateness : std::min(max_lateness, Time(int64_t(1) << i));
         }
     }
+    return max_lateness;
 }
 
+void Timer::record(Time lateness) {
+    int64_t us = std::max<int64_t>(0, lateness.count());
+    int bucket = 0;
+    while (bucket < Stats::kBuckets - 1 && us >= (int64_t(1) << bucket)) {
+        bucket++;
+    }
+    stats_.lateness[bucket]++;
+    stats_.callbacks++;
+    stats_.max_lateness = std::max(stats_.max_lateness, lateness);
+}
+
+void Timer::timerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!shutdown_) {
+        uint64_t generation = generation_;
+        Time due = time_.running() ? std::min(wake_, periodic_ ? next_tick_ : kNever) : kNever;
+        auto changed = [&] { return shutdown_ || generation_ != generation; };
+        if (due == kNever) {
+            blockUntil(wake_cv_, lock, changed);
+            continue;
+        }
+        auto deadline = time_.when(due);
+        // Returns true on any change; false once the deadline passes.
+        if (wake_cv_.wait_until(lock, deadline, changed)) {
+            continue;
+        }
+
+        // A wake-up and a tick that come due together share one callback,
+        // which counts once, as late as the earlier of the two.
+        Time now = time_.now();
+        bool fire = false;
+        Time lateness = Time::zero();
+        if (wake_ <= now) {
+            lateness = now - wake_;
+            wake_ = kNever;
+            fire = true;
+        }
+        if (periodic_ && next_tick_ <= now) {
+            Time tick = tickLength();
+            int64_t behind = (now - next_tick_) / tick;
+            if (behind > 0 && policy_ == OverrunPolicy::SKIP) {
+                stats_.missed_ticks += behind;
+                next_tick_ += behind * tick;
+            } else if (behind > 0) {
+                stats_.late_ticks++;
+            }
+            lateness = std::max(lateness, now - next_tick_);
+            next_tick_ += tick;
+            fire = true;
+        }
+        if (!fire) {
+            continue;
+        }
+        record(lateness);
+
+        firing_ = true;
+        lock.unlock();
+        callback_();
+        lock.lock();
+        firing_ = false;
+        idle_cv_.notify_all();
+    }
+}
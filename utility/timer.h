@@ -1,23 +1,81 @@
 #pragma once
+#include "clock_source.h"
 #include <functional>
 #include <thread>
 #include <chrono>
-#include <atomic>
+#include <condition_variable>
+#include <mutex>
 
-class Timer {
+// Real-time clock on a thread of its own. Game time follows steady_clock
+// while running, and every deadline is an absolute point on it, so
+// callbacks that run long or wake late never push later ones back. The
+// thread starts with the first start() and lives until the Timer is
+// destroyed; stop() and start() only freeze and resume game time.
+//
+// Besides wake-ups, the Timer can tick periodically on the grid of whole
+// ticks of game time. Ticks that fall due while the thread is behind are
+// either all delivered back to back or dropped, per OverrunPolicy.
+class Timer : public ClockSource {
 public:
+    enum class OverrunPolicy {
+        CATCH_UP,
+        SKIP
+    };
+
+    struct Stats {
+        static constexpr int kBuckets = 24;
+        // lateness[0] counts callbacks under 1 us late, lateness[i] those
+        // 2^(i-1) to 2^i us late; the last bucket also takes anything later.
+        uint64_t lateness[kBuckets] = {};
+        uint64_t callbacks = 0;
+        Time max_lateness = Time::zero();
+        // Ticks dropped under SKIP, and ticks delivered a whole tick or
+        // more late under CATCH_UP.
+        uint64_t missed_ticks = 0;
+        uint64_t late_ticks = 0;
+
+        // Upper edge of the bucket holding the given fraction of callbacks,
+        // capped at the maximum seen.
+        Time percentile(double fraction) const;
+    };
+
     Timer();
-    ~Timer();
+    ~Timer() override;
 
-    void setTickRate(int milliseconds);
-    void start(std::function<void()> callback);
-    void stop();
+    void setTickRate(int milliseconds) override;
+    int tickRate() const override;
+    void start(std::function<void()> callback) override;
+    void stop() override;
+    Time now() const override;
+    void wakeAt(Time when) override;
+
+    // Also calls back at every whole tick of game time. Off by default.
+    void setPeriodic(bool periodic, OverrunPolicy policy = OverrunPolicy::CATCH_UP);
+
+    Stats stats() const;
+    void resetStats();
 
 private:
-    void timerLoop(std::function<void()> callback);
+    void timerLoop();
+    Time tickLength() const { return std::chrono::milliseconds(tick_rate_ms_); }
+    void record(Time lateness);
 
+    mutable std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable idle_cv_;
+    std::function<void()> callback_;
     int tick_rate_ms_;
-    std::atomic<bool> running_;
+    bool shutdown_;
+    // Set while the callback runs.
+    bool firing_;
+    bool periodic_;
+    OverrunPolicy policy_;
+    // Also tells whether the timer runs.
+    SteadyGameTime time_;
+    Time wake_;
+    Time next_tick_;
+    // Bumped on every change the sleeping thread must pick up.
+    uint64_t generation_;
+    Stats stats_;
     std::thread timer_thread_;
 };
-
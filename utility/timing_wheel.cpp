@@ -0,0 +1,189 @@
+#include "timing_wheel.h"
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+constexpr TimingWheel::Tick kSpan = TimingWheel::Tick(1) << (TimingWheel::kSlotBits * TimingWheel::kLevels);
+constexpr int kIndexBits = TimingWheel::kHandleBits - 32;
+constexpr uint64_t kIndexMask = (uint64_t(1) << kIndexBits) - 1;
+
+int lowestBit(uint64_t bits) {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(bits);
+#endif
+}
+
+uint64_t rotateRight(uint64_t bits, int shift) {
+    return shift == 0 ? bits : (bits >> shift) | (bits << (64 - shift));
+}
+
+int levelShift(int level) {
+    return TimingWheel::kSlotBits * level;
+}
+
+}
+
+TimingWheel::TimingWheel(Tick start) : now_(start), size_(0) {
+    std::fill(std::begin(heads_), std::end(heads_), kNone);
+    std::fill(std::begin(occupied_), std::end(occupied_), 0);
+}
+
+TimingWheel::Handle TimingWheel::insert(Tick when, std::function<void()> callback) {
+    uint32_t index;
+    if (!free_.empty()) {
+        index = free_.back();
+        free_.pop_back();
+    } else {
+        index = static_cast<uint32_t>(nodes_.size());
+        nodes_.emplace_back();
+    }
+
+    Node& node = nodes_[index];
+    node.expiry = std::max(when, now_ + 1);
+    node.used = true;
+    node.callback = std::move(callback);
+    link(index);
+    size_++;
+
+    return makeHandle(index);
+}
+
+bool TimingWheel::cancel(Handle handle) {
+    uint32_t index = indexOf(handle);
+    if (index == kNone) {
+        return false;
+    }
+    unlink(index);
+    nodes_[index].callback = nullptr;
+    release(index);
+    return true;
+}
+
+TimingWheel::Tick TimingWheel::nextEventTick() const {
+    Tick best = kNoTick;
+    for (int level = 0; level < kLevels; level++) {
+        if (!occupied_[level]) {
+            continue;
+        }
+        // The slot after the current one comes up first; a slot of a
+        // higher level is due when the wheel reaches the start of its span.
+        Tick unit = now_ >> levelShift(level);
+        int from = static_cast<int>((unit + 1) & (kSlots - 1));
+        Tick distance = 1 + lowestBit(rotateRight(occupied_[level], from));
+        best = std::min(best, (unit + distance) << levelShift(level));
+    }
+    return best;
+}
+
+void TimingWheel::advance(Tick tick, std::vector<Expired>& expired) {
+    while (true) {
+        Tick next = nextEventTick();
+        if (next > tick) {
+            now_ = std::max(now_, tick);
+            return;
+        }
+
+        now_ = next;
+        for (int level = kLevels - 1; level > 0; level--) {
+            Tick mask = (Tick(1) << levelShift(level)) - 1;
+            if ((now_ & mask) == 0) {
+                cascade(level, static_cast<int>((now_ >> levelShift(level)) & (kSlots - 1)));
+            }
+        }
+
+        int slot = static_cast<int>(now_ & (kSlots - 1));
+        while (heads_[slot] != kNone) {
+            uint32_t index = heads_[slot];
+            unlink(index);
+            expired.push_back(Expired{makeHandle(index), std::move(nodes_[index].callback)});
+            nodes_[index].callback = nullptr;
+            release(index);
+        }
+    }
+}
+
+void TimingWheel::link(uint32_t index) {
+    Node& node = nodes_[index];
+    Tick placed = node.expiry;
+    if (placed - now_ >= kSpan) {
+        placed = now_ + kSpan - 1;
+    }
+
+    int level = 0;
+    while (level < kLevels - 1 && placed - now_ >= (Tick(1) << levelShift(level + 1))) {
+        level++;
+    }
+    int slot = static_cast<int>((placed >> levelShift(level)) & (kSlots - 1));
+    uint16_t position = static_cast<uint16_t>(level * kSlots + slot);
+
+    node.slot = position;
+    node.prev = kNone;
+    node.next = heads_[position];
+    if (node.next != kNone) {
+        nodes_[node.next].prev = index;
+    }
+    heads_[position] = index;
+    occupied_[level] |= uint64_t(1) << slot;
+}
+
+void TimingWheel::unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    if (node.prev != kNone) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[node.slot] = node.next;
+        if (node.next == kNone) {
+            occupied_[node.slot / kSlots] &= ~(uint64_t(1) << (node.slot % kSlots));
+        }
+    }
+    if (node.next != kNone) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.prev = kNone;
+    node.next = kNone;
+}
+
+void TimingWheel::cascade(int level, int slot) {
+    uint32_t position = level * kSlots + slot;
+    uint32_t index = heads_[position];
+    heads_[position] = kNone;
+    occupied_[level] &= ~(uint64_t(1) << slot);
+    while (index != kNone) {
+        uint32_t next = nodes_[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+void TimingWheel::release(uint32_t index) {
+    Node& node = nodes_[index];
+    node.used = false;
+    // Generation 0 is skipped so that no handle is ever 0.
+    node.generation = node.generation + 1 == 0 ? 1 : node.generation + 1;
+    free_.push_back(index);
+    size_--;
+}
+
+TimingWheel::Handle TimingWheel::makeHandle(uint32_t index) const {
+    return (Handle(nodes_[index].generation) << kIndexBits) | index;
+}
+
+uint32_t TimingWheel::indexOf(Handle handle) const {
+    uint64_t index = handle & kIndexMask;
+    if (index >= nodes_.size()) {
+        return kNone;
+    }
+    const Node& node = nodes_[index];
+    if (!node.used || (handle >> kIndexBits) != node.generation) {
+        return kNone;
+    }
+    return static_cast<uint32_t>(index);
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+// Hierarchical timing wheel: four levels of 64 slots, each level 64 times
+// coarser than the one below, covering 2^24 ticks ahead. A timer sits in the
+// slot of the coarsest level its distance needs and moves down a level when
+// the wheel reaches that slot, so insert and cancel are O(1) and advancing
+// costs one step per expiry or cascade, not per tick. A timer further out
+// than the wheel spans is parked in the top level and re-placed as the
+// wheel turns.
+//
+// Not thread-safe; Scheduler puts one behind each of its threads.
+class TimingWheel {
+public:
+    using Tick = uint64_t;
+    // Node generation above a 24-bit node index; never 0.
+    using Handle = uint64_t;
+    static constexpr Tick kNoTick = std::numeric_limits<Tick>::max();
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 6;
+    static constexpr int kSlots = 1 << kSlotBits;
+    // Handles use the low 56 bits, leaving the top byte to the caller.
+    static constexpr int kHandleBits = 56;
+
+    struct Expired {
+        Handle handle;
+        std::function<void()> callback;
+    };
+
+    explicit TimingWheel(Tick start = 0);
+
+    Tick now() const { return now_; }
+    size_t size() const { return size_; }
+
+    // A tick not after now() fires on the next advance.
+    Handle insert(Tick when, std::function<void()> callback);
+    // False if the timer has already fired or been cancelled.
+    bool cancel(Handle handle);
+
+    // First tick at which advance() has work to do, or kNoTick when empty.
+    Tick nextEventTick() const;
+    // Moves the wheel to `tick`, appending the timers that expire on the way
+    // to `expired` in expiry order.
+    void advance(Tick tick, std::vector<Expired>& expired);
+
+private:
+    static constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+
+    struct Node {
+        Tick expiry = 0;
+        uint32_t prev = kNone;
+        uint32_t next = kNone;
+        uint32_t generation = 1;
+        uint16_t slot = 0;
+        bool used = false;
+        std::function<void()> callback;
+    };
+
+    void link(uint32_t index);
+    void unlink(uint32_t index);
+    void cascade(int level, int slot);
+    void release(uint32_t index);
+    Handle makeHandle(uint32_t index) const;
+    uint32_t indexOf(Handle handle) const;
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> free_;
+    uint32_t heads_[kLevels * kSlots];
+    uint64_t occupied_[kLevels];
+    Tick now_;
+    size_t size_;
+};